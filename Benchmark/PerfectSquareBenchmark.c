@@ -0,0 +1,99 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * The number of inputs of every set.
+ */
+#define INPUTS (1LL << 22)
+
+/**
+ * The number of passes over every set.
+ */
+#define PASSES 5
+
+
+/**
+ * Checks if a number is a perfect square with the double-precision square root.
+ * @details the previous isPerfectSquare, kept as the reference of the benchmark.
+ *
+ * @param n the number.
+ * @return 1 if the number is a perfect square, 0 otherwise.
+ */
+static long long int doublePerfectSquare(long long int n) {
+    //The integer part of square root.
+    long long int sq = (long long int) sqrt(n);
+
+    return sq * sq == n;
+}
+
+/**
+ * Checks if a number is a perfect square with the 128-bit test.
+ *
+ * @param n the number.
+ * @return 1 if the number is a perfect square, 0 otherwise.
+ */
+static long long int perfectSquare128(long long int n) {
+    return isPerfectSquare128((unsigned __int128) n);
+}
+
+/**
+ * Times a perfect-square test on a set of inputs.
+ *
+ * @param name the name of the test.
+ * @param set the name of the set.
+ * @param input the inputs.
+ * @param test the perfect-square test.
+ */
+static void benchmark(const char *name, const char *set, long long int *input, long long int (*test)(long long int)) {
+    //The number of perfect squares found, printed so the calls are not optimised away.
+    long long int squares = 0;
+    //The start time.
+    clock_t start = clock();
+    //The elapsed seconds.
+    double seconds = 0;
+
+    for (int pass = 0; pass < PASSES; ++pass) {
+        for (long long int i = 0; i < INPUTS; ++i) {
+            squares += test(input[i]);
+        }
+    }
+    seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    printf("%-20s %-8s %6.2f ns/call (%lld squares)\n", name, set, 1e9 * seconds / (PASSES * INPUTS), squares);
+}
+
+
+int main() {
+    //The random inputs below 2^62.
+    long long int *random = malloc(INPUTS * sizeof(long long int));
+    //The values x^2 - n of a Fermat factorisation loop.
+    long long int *fermat = malloc(INPUTS * sizeof(long long int));
+    //The state of the pseudo-random generator.
+    unsigned long long int state = 42;
+    //The Fermat x.
+    long long int x = 2000000000LL;
+    //The Fermat value y = x^2 - n, updated as y + 2x + 1.
+    long long int y = 12345;
+
+    for (long long int i = 0; i < INPUTS; ++i) {
+        random[i] = (long long int) (nextRandom(&state) >> 2);
+        fermat[i] = y;
+        y += 2 * x + 1;
+        x++;
+    }
+
+    benchmark("sqrt(double)", "random", random, doublePerfectSquare);
+    benchmark("isPerfectSquare", "random", random, isPerfectSquare);
+    benchmark("isPerfectSquare128", "random", random, perfectSquare128);
+    benchmark("sqrt(double)", "fermat", fermat, doublePerfectSquare);
+    benchmark("isPerfectSquare", "fermat", fermat, isPerfectSquare);
+    benchmark("isPerfectSquare128", "fermat", fermat, perfectSquare128);
+
+    free(random);
+    free(fermat);
+    return 0;
+}
@@ -3,6 +3,7 @@
     #define MODULARARITHMETIC_H
 
     #include "Modular_Arithmetic/Utility/Matrix.h"
+    #include "Modular_Arithmetic/Utility/HashTable.h"
 
 
     //*********************//
@@ -35,6 +36,7 @@
     /**
      * Computes the product modulo m.
      * @details res = a * b (mod m).
+     * @details the product is computed on 128 bits, so it does not overflow for any m.
      *
      * @param a the first factor.
      * @param b the second factor.
@@ -71,16 +73,18 @@
      * Computes the square roots modulo p of a number.
      * @details Tonelli-Shanks algorithm
      * @details two different result (+res && -res)
-     * @warning p must be a prime number.
+     * @warning p must be an odd prime number, it is not tested.
      *
      * @param a the number whose square root is to be calculated.
      * @param p the module value.
-     * @return the square roots modulo p of the number.
+     * @return the square roots modulo p of the number, NULL if a is not a quadratic residue modulo p.
      */
     long long int *TonelliShanksAlgorithm(long long int a, long long int p);
 
     /**
      * Computes the square roots modulo m of a number.
+     * @details factorisation of m, Hensel lifting modulo every prime power and Chinese Reminder Theorem - see allSquareRoots.
+     * @details the square roots are sorted.
      * @warning a must be a quadratic residue modulo m.
      *
      * @param a the number whose square root is to be calculated.
@@ -93,13 +97,14 @@
     /**
      * Computes the discrete logarithm modulo n of base number.
      * @details Baby-Step Giant-Step algorithm.
+     * @details the baby steps are stored in a hash table, so the algorithm takes O(sqrt(m)) time and memory.
      * @details b = base^x (mod n) where x = Log_(base) (b).
-     * @warning base must be base primitive root modulo m.
+     * @warning base should be a primitive root modulo m, otherwise the logarithm may not exist.
      *
      * @param base the logarithm base.
      * @param b the number.
      * @param m the module value.
-     * @return the discrete logarithm modulo n.
+     * @return the discrete logarithm modulo n, -1 if it does not exist.
      */
     long long int discreteLogarithm(long long int base, long long int b, long long int m);
 
@@ -118,7 +123,8 @@
      * @example x = a1 (mod m1)
      * @example ...
      * @example x = ai (mod mi)
-     * @warning all mi value must be coprime.
+     * @details Garner's algorithm, see createCrtContext; use a precomputation to solve many systems with the same module values.
+     * @warning all mi value must be coprime, their product must be lower than 2^63.
      *
      * @param numberOfEquation the number of equations of the linear system.
      * @param a the parameters.
@@ -127,6 +133,115 @@
      */
     long long int chineseReminderTheorem(long long int numberOfEquation, long long int *a, long long int *m);
 
+
+    /**
+     * Struct --> represents the Garner precomputation of the Chinese Reminder Theorem for fixed module values.
+     *
+     * @details size - the number of module values.
+     * @details m - the module values, pairwise coprime.
+     * @details radix - the mixed-radix constants m_0 * ... * m_(j-1) (mod m_i) for j < i, row i starts at i * (i - 1) / 2.
+     * @details inverse - the inverse of m_0 * ... * m_(i-1) modulo m_i.
+     * @details modulus - the product of the module values, 0 if it is not lower than 2^63.
+     * @details words - the number of 64-bit words of the product of the module values.
+     */
+    typedef struct CrtContext {
+        long long int size;
+        long long int *m;
+        long long int *radix;
+        long long int *inverse;
+        long long int modulus;
+        long long int words;
+    }crtContext;
+
+
+    /**
+     * Creates the Garner precomputation of the Chinese Reminder Theorem.
+     * @details O(k^2) products modulo the module values, then every reconstruction takes O(k^2) products and no inverse.
+     * @details the module values are pairwise coprime iff every m_0 * ... * m_(i-1) is invertible modulo m_i.
+     *
+     * @param numberOfEquation the number of module values.
+     * @param m the module values, they are copied.
+     * @return the precomputation, NULL if the module values are not pairwise coprime.
+     */
+    crtContext *createCrtContext(long long int numberOfEquation, long long int *m);
+
+    /**
+     * Computes the mixed-radix digits of the solution of a system of modular linear equations.
+     * @details Garner's algorithm: x = v_0 + v_1 * m_0 + ... + v_(k-1) * m_0 * ... * m_(k-2) with 0 <= v_i < m_i.
+     *
+     * @param context the Garner precomputation.
+     * @param a the parameters, a_i modulo m_i.
+     * @param digits the mixed-radix digits, k values.
+     */
+    void crtMixedRadix(crtContext *context, long long int *a, long long int *digits);
+
+    /**
+     * Computes the solution of a system of modular linear equations using the Garner precomputation.
+     * @warning the product of the module values must be lower than 2^63.
+     *
+     * @param context the Garner precomputation.
+     * @param a the parameters, a_i modulo m_i.
+     * @return the solution modulo the product of the module values.
+     */
+    long long int crtReconstruct(crtContext *context, long long int *a);
+
+    /**
+     * Computes the solution of a system of modular linear equations on 128 bits using the Garner precomputation.
+     * @warning the product of the module values must be lower than 2^128.
+     *
+     * @param context the Garner precomputation.
+     * @param a the parameters, a_i modulo m_i.
+     * @return the solution modulo the product of the module values.
+     */
+    unsigned __int128 crtReconstruct128(crtContext *context, long long int *a);
+
+    /**
+     * Computes the solution of a system of modular linear equations on many words using the Garner precomputation.
+     * @details the mixed-radix digits are combined by Horner's rule, one multiplication by a word per module value.
+     *
+     * @param context the Garner precomputation.
+     * @param a the parameters, a_i modulo m_i.
+     * @param res the solution modulo the product of the module values, context->words 64-bit words, least significant first.
+     */
+    void crtReconstructWords(crtContext *context, long long int *a, unsigned long long int *res);
+
+    /**
+     * Computes the solution of many systems of modular linear equations using the Garner precomputation.
+     * @warning the product of the module values must be lower than 2^63.
+     *
+     * @param context the Garner precomputation.
+     * @param numberOfValues the number of systems.
+     * @param a the parameters, numberOfValues rows of k values.
+     * @param res the solution of every system.
+     */
+    void crtReconstructBatch(crtContext *context, long long int numberOfValues, long long int *a, long long int *res);
+
+    /**
+     * Deletes the Garner precomputation of the Chinese Reminder Theorem.
+     *
+     * @param context the precomputation to be deleted.
+     */
+    void deleteCrtContext(crtContext *context);
+
+    /**
+     * Computes the solution of a system of modular linear equations whose module values may share factors.
+     * @details generalized Chinese Reminder Theorem: two equations x = a1 (mod m1), x = a2 (mod m2) have a solution iff
+     * @details g = gcd(m1, m2) divides a2 - a1, then x = a1 + m1 * t (mod lcm(m1, m2)) with t = (a2 - a1)/g * (m1/g)^-1 (mod m2/g).
+     * @details the equations are merged on a divide-and-conquer tree, so the operands stay balanced.
+     * @example x = a1 (mod m1)
+     * @example ...
+     * @example x = ai (mod mi)
+     *
+     * @param numberOfEquation the number of equations of the linear system.
+     * @param a the parameters.
+     * @param m the module values, positive.
+     * @param x the solution modulo the lcm of the module values.
+     * @param lcm the lcm of the module values.
+     * @return 1 if the system has a solution, 0 if it is inconsistent, -1 if the lcm of the module values is not lower than 2^63.
+     */
+    long long int generalizedChineseReminderTheorem(long long int numberOfEquation, long long int *a, long long int *m,
+                                                    long long int *x, long long int *lcm);
+
     /**
      * Computes the solution of a linear diophantine equation.
      * @details ax + by = c
@@ -141,6 +256,37 @@
      */
     void diophantineEquation(long long int a, long long int *x, long long int b, long long int *y, long long int c);
 
+    /**
+     * Computes the solutions of a linear congruence.
+     * @details a * x == b (mod m) has a solution iff g = gcd(a, m) divides b, then the g solutions are
+     * @details x = base + k * step (mod m) for 0 <= k < g, with step = m / g and base = (b/g) * (a/g)^-1 (mod m/g).
+     *
+     * @param a the coefficient.
+     * @param b the known term.
+     * @param m the module value.
+     * @param base the smallest solution.
+     * @param step the distance between two consecutive solutions, m / gcd(a, m).
+     * @return the number of solutions modulo m, gcd(a, m), 0 if there is no solution.
+     */
+    long long int linearCongruence(long long int a, long long int b, long long int m, long long int *base, long long int *step);
+
+    /**
+     * Computes a solution of a system of linear congruences.
+     * @details A * x == b (mod m) with m composite: the Smith normal form D = U * A * V (mod m) is diagonal,
+     * @details U and V are products of unimodular combinations of rows and columns, see combineLines.
+     * @details then D * y == U * b is made of linear congruences d_i * y_i == c_i and x = V * y.
+     * @details there are prod(gcd(d_i, m)) solutions, m for every column without pivot.
+     * @details the elimination is exact on 64-bit integers, only the matrices hold doubles.
+     * @warning m must be at most 2^53, the residues are read from and written to double matrices.
+     *
+     * @param a the coefficients - M: k x n.
+     * @param b the known terms - M: k x 1.
+     * @param x a solution - M: n x 1.
+     * @param m the module value.
+     * @return the number of solutions modulo m, 0 if there is no solution, -1 if they are not less than 2^63.
+     */
+    long long int linearSystemModulo(matrix *a, matrix *b, matrix *x, long long int m);
+
 
     //******************************************************************************************************************//
 
@@ -194,6 +340,16 @@
      */
     long long int isFermatPseudoPrime(long long int a, long long int n);
 
+    /**
+     * Checks if a number is a prime number with the Miller-Rabin test.
+     * @details n - 1 = d * 2^s with d odd, n is a strong probable prime to base a if a^d == 1 or a^(d * 2^r) == -1 for some r < s.
+     * @details the bases 2, 3, 5, ..., 37 make the test deterministic for every n < 2^64, O(log^3 n) and no memory.
+     *
+     * @param n the number whose primality is to be tested.
+     * @return 1 if the number is prime, 0 otherwise.
+     */
+    long long int MillerRabinTest(long long int n);
+
     /**
      * Checks if a number is a prime number.
      * @details Eratosthenes sieve.
@@ -207,6 +363,7 @@
      * Checks if a number admits the square root modulo n.
      * @details a is a quadratic residue modulo n.
      * @details if: exist x st x^2 = a (mod n).
+     * @details counts the square roots modulo every prime power of n, see allSquareRoots; use a quadratic residue bitmap for many queries.
      *
      * @param a the number whose square root we want to know if it is possible to calculate.
      * @param n the module value.
@@ -217,6 +374,7 @@
     /**
      * Checks is a number is a primitive root modulo n.
      * @details an integer whose powers modulo n are congruent with numbers coprime to n.
+     * @details see isPrimitiveRootFromDescriptor; use a descriptor to test many numbers modulo the same n.
      *
      * @param a the number to check if it is primitive root modulo n.
      * @param n the module value.
@@ -233,16 +391,44 @@
     //*******************************************//
 
 
+    /**
+     * Computes the integer square root of a number.
+     * @details floor(sqrt(n)): double-precision estimate, then exact correction on integers.
+     * @warning n must be non-negative.
+     *
+     * @param n the number.
+     * @return the largest x st x^2 <= n.
+     */
+    long long int integerSquareRoot(long long int n);
+
+    /**
+     * Computes the integer square root of a 128-bit number.
+     * @details floor(sqrt(n)): long double estimate, one Newton step x = (x + n/x)/2, then exact correction.
+     *
+     * @param n the number.
+     * @return the largest x st x^2 <= n.
+     */
+    unsigned long long int integerSquareRoot128(unsigned __int128 n);
+
     /**
      * Checks if a number is a perfect square.
-     * @details x = sqrt(n)
-     * @details if n == x * x --> n is a perfect square
+     * @details the squares modulo 64 reject 52/64 of the numbers with one bit test, then n == x * x with x the exact integer square root.
+     * @details the filters modulo 63, 65 and 11 are left to isPerfectSquare128: here they cost more than the double-precision root.
      *
      * @param n the number.
      * @return 1 if the number is a perfect square, 0 otherwise.
      */
     long long int isPerfectSquare(long long int n);
 
+    /**
+     * Checks if a 128-bit number is a perfect square.
+     * @details the squares modulo 64, 63, 65 and 11 reject about 99% of the numbers, then n == x * x with x the exact integer square root.
+     *
+     * @param n the number.
+     * @return 1 if the number is a perfect square, 0 otherwise.
+     */
+    int isPerfectSquare128(unsigned __int128 n);
+
     /**
      * Checks if a number is in a list.
      * @warning list must be not NULL.
@@ -299,6 +485,15 @@
      */
     long long int congruentNumber(long long int a, long long int m);
 
+    /**
+     * Computes the next pseudo-random number.
+     * @details SplitMix64 generator: deterministic for a given seed and thread-safe, every caller owns its state.
+     *
+     * @param state the state of the generator, updated.
+     * @return the pseudo-random number.
+     */
+    unsigned long long int nextRandom(unsigned long long int *state);
+
 
     /**
      * Computes the modular reduction.
@@ -345,10 +540,12 @@
 
     /**
      * Factorizes a number by splitting it into all of its dividends.
+     * @details trial division by the numbers below 1024, then the cofactor is split with Pollard's rho
+     * @details until every part passes the Miller-Rabin test, O(n^(1/4)) expected steps for any n below 2^63.
      *
      * @param n the number.
      * @param factors the number of factors.
-     * @return the factors that make up the number.
+     * @return the factors that make up the number, sorted.
      */
     long long int *factorisation(long long int n, long long int *factors);
 
@@ -362,6 +559,16 @@
      */
     long long int EulerFunction(long long int n);
 
+    /**
+     * Computes the value of the Carmichael function for a number.
+     * @details λ(n), the smallest exponent st a^λ(n) == 1 (mod n) for every a coprime to n.
+     * @details λ(2) = 1, λ(4) = 2, λ(2^e) = 2^(e-2) for e > 2, λ(p^e) = p^(e-1) * (p-1), λ(n) = lcm(λ(p^e)).
+     *
+     * @param n the number.
+     * @return the value of Carmichael's function.
+     */
+    long long int CarmichaelLambda(long long int n);
+
 
     /**
      * Computes the list of prime numbers up to the n-th.
@@ -393,6 +600,9 @@
 
     /**
      * Computes the list of primitive roots modulo n.
+     * @details a primitive root g is found once, the others are g^k with gcd(k, φ(n)) = 1, one multiplication each.
+     * @details the exponents coprime to φ(n) are sieved by the prime factors of φ(n), the roots are marked in a bitmap to be listed sorted.
+     * @details there are φ(φ(n)) primitive roots if n is 1, 2, 4, p^k or 2p^k with p an odd prime, none otherwise.
      *
      * @param n the module value.
      * @param primitiveRootsSize the number of primitive root modulo n.
@@ -402,6 +612,7 @@
 
     /**
      * Computes the list of quadratic residuals modulo n.
+     * @details the residues are read from the quadratic residue bitmap, 0 included.
      *
      * @param n the module value.
      * @param quadraticResidualSize the number of quadratic residuals modulo n.
@@ -412,6 +623,7 @@
 
     /**
      * Computes the Legendre symbol.
+     * @details Jacobi symbol of a prime, no primality test.
      * @warning p must be an odd prime number.
      *
      * @param a the number.
@@ -423,7 +635,9 @@
     /**
      * Computes the Jacobi symbol.
      * @details Jacobi symbol is a generalization of the Legendre symbol.
-     * @warning n must be an odd number.
+     * @details binary algorithm: the factors 2 of a are removed with (2|n) = (-1)^((n^2-1)/8),
+     * @details then a and n are swapped with quadratic reciprocity, O(log^2 n) without factorisation.
+     * @warning n must be an odd positive number.
      *
      * @param a the number.
      * @param n the odd number.
@@ -431,6 +645,138 @@
      */
     long long int JacobiSymbol(long long int a, long long int n);
 
+    /**
+     * Computes the Kronecker symbol.
+     * @details Kronecker symbol is a generalization of the Jacobi symbol to every integer n.
+     * @details (a|-1) = -1 iff a < 0, (a|2) = 0 if a is even, -1 iff a == 3, 5 (mod 8), (a|0) = 1 iff a = ±1.
+     *
+     * @param a the number.
+     * @param n the number.
+     * @return the Kronecker symbol, 1, -1 or 0.
+     */
+    long long int KroneckerSymbol(long long int a, long long int n);
+
+
+    /**
+     * Struct --> represents a module value with its factorisation and the one of φ(m), computed once.
+     *
+     * @details m - the module value.
+     * @details factor - the distinct prime factors of m, sorted.
+     * @details exponent - the exponent of every prime factor of m.
+     * @details factorSize - the number of distinct prime factors of m.
+     * @details phi - the value of Euler's function φ(m).
+     * @details phiFactor - the distinct prime factors of φ(m), sorted.
+     * @details phiExponent - the exponent of every prime factor of φ(m).
+     * @details phiFactorSize - the number of distinct prime factors of φ(m).
+     * @details lambda - the value of Carmichael's function λ(m), the exponent of the units modulo m.
+     * @details lambdaFactor - the distinct prime factors of λ(m), sorted.
+     * @details lambdaExponent - the exponent of every prime factor of λ(m).
+     * @details lambdaFactorSize - the number of distinct prime factors of λ(m).
+     */
+    typedef struct ModulusDescriptor {
+        long long int m;
+        long long int *factor;
+        long long int *exponent;
+        long long int factorSize;
+        long long int phi;
+        long long int *phiFactor;
+        long long int *phiExponent;
+        long long int phiFactorSize;
+        long long int lambda;
+        long long int *lambdaFactor;
+        long long int *lambdaExponent;
+        long long int lambdaFactorSize;
+    }modulusDescriptor;
+
+
+    /**
+     * Creates the descriptor of a module value, so that its factorisation and the ones of φ(m) and λ(m) are computed once.
+     * @details φ(m) = prod(p^(e-1) * (p-1)), its prime factors are the ones of every p - 1 and every p with e > 1.
+     * @details λ(m) = lcm(λ(p^e)) divides φ(m), its prime factors are among the ones of φ(m).
+     *
+     * @param m the module value.
+     * @return the descriptor of the module value.
+     */
+    modulusDescriptor *createModulusDescriptor(long long int m);
+
+    /**
+     * Deletes the descriptor of a module value.
+     *
+     * @param descriptor the descriptor to be deleted.
+     */
+    void deleteModulusDescriptor(modulusDescriptor *descriptor);
+
+    /**
+     * Checks if there are primitive roots modulo the module value of a descriptor.
+     * @details the units modulo m are cyclic iff m is 1, 2, 4, p^k or 2p^k with p an odd prime.
+     *
+     * @param descriptor the descriptor of the module value.
+     * @return 1 if there are primitive roots modulo m, 0 otherwise.
+     */
+    long long int hasPrimitiveRoot(modulusDescriptor *descriptor);
+
+    /**
+     * Checks is a number is a primitive root modulo the module value of a descriptor.
+     * @details the units modulo m must be cyclic, a coprime to m and a^(φ(m)/q) != 1 for every prime q dividing φ(m).
+     * @details the prime factors of φ(m) are read from the descriptor, they are not recomputed.
+     *
+     * @param a the number to check if it is primitive root modulo m.
+     * @param descriptor the descriptor of the module value.
+     * @return 1 if the number is a primitive root modulo m, 0 otherwise.
+     */
+    long long int isPrimitiveRootFromDescriptor(long long int a, modulusDescriptor *descriptor);
+
+    /**
+     * Finds the smallest primitive root modulo the module value of a descriptor.
+     * @details sequential search: every candidate costs one exponentiation per prime factor of φ(m), factorised once.
+     * @details the smallest primitive root is O(p^(1/4 + ε)) modulo a prime p, so only few candidates are tested.
+     *
+     * @param descriptor the descriptor of the module value.
+     * @return the smallest primitive root modulo m, -1 if there are no primitive roots modulo m.
+     */
+    long long int primitiveRootFromDescriptor(modulusDescriptor *descriptor);
+
+    /**
+     * Finds the smallest primitive root modulo n.
+     * @details see primitiveRootFromDescriptor.
+     *
+     * @param n the module value.
+     * @return the smallest primitive root modulo n, -1 if there are no primitive roots modulo n.
+     */
+    long long int primitiveRoot(long long int n);
+
+    /**
+     * Computes the multiplicative order modulo the module value of a descriptor.
+     * @details the order divides λ(m): for every prime q^f dividing λ(m), y = a^(λ(m)/q^f) is raised to q until it is 1,
+     * @details the number of times is the exponent of q in the order; the factorisation of λ(m) is read from the descriptor.
+     *
+     * @param a the number.
+     * @param descriptor the descriptor of the module value.
+     * @return the smallest k > 0 st a^k == 1 (mod m), 0 if a and m are not coprime.
+     */
+    long long int multiplicativeOrderFromDescriptor(long long int a, modulusDescriptor *descriptor);
+
+    /**
+     * Computes the multiplicative order modulo n.
+     * @details see multiplicativeOrderFromDescriptor.
+     *
+     * @param a the number.
+     * @param n the module value.
+     * @return the smallest k > 0 st a^k == 1 (mod n), 0 if a and n are not coprime.
+     */
+    long long int multiplicativeOrder(long long int a, long long int n);
+
+    /**
+     * Computes the multiplicative order of many numbers modulo the module value of a descriptor.
+     * @details see multiplicativeOrderFromDescriptor, λ(m) is factorised once for every number.
+     *
+     * @param descriptor the descriptor of the module value.
+     * @param numberOfValues the number of numbers.
+     * @param a the numbers.
+     * @param res the multiplicative order of every number, 0 where it is not coprime to m.
+     */
+    void multiplicativeOrderBatch(modulusDescriptor *descriptor, long long int numberOfValues, long long int *a, long long int *res);
+
 
     //******************************************************************************************************************//
 
@@ -543,4 +889,1198 @@
      */
     void kroneckerProductMatrixModulo(matrix *a, matrix *b, matrix *res, long long int n);
 
+
+    //******************************************************************************************************************//
+
+
+    //*************************//
+    //  COMPRESSED PRIME LIST  //
+    //*************************//
+
+
+    /**
+     * Struct --> represents a gap-encoded list of prime numbers.
+     *
+     * @details gaps - the half-gaps between consecutive primes as varbytes: 7 bits per byte, the high bit marks that another byte follows.
+     * @details gapsSize - the number of bytes used by gaps.
+     * @details checkpointValue - the absolute value of every checkpointInterval-th prime.
+     * @details checkpointOffset - the position in gaps of the first gap following each checkpoint.
+     * @details checkpointSize - the number of checkpoints.
+     * @details checkpointInterval - the number of primes between two consecutive checkpoints.
+     * @details size - the number of primes in the list.
+     */
+    typedef struct CompressedPrimeList {
+        unsigned char *gaps;
+        long long int gapsSize;
+        long long int *checkpointValue;
+        long long int *checkpointOffset;
+        long long int checkpointSize;
+        long long int checkpointInterval;
+        long long int size;
+    }compressedPrimeList;
+
+    /**
+     * Struct --> represents a streaming decoder over a gap-encoded list of prime numbers.
+     *
+     * @details list - the list to decode.
+     * @details index - the index of the next prime to decode.
+     * @details offset - the position in gaps of the gap following value.
+     * @details value - the next prime to decode.
+     */
+    typedef struct CompressedPrimeDecoder {
+        compressedPrimeList *list;
+        long long int index;
+        long long int offset;
+        long long int value;
+    }compressedPrimeDecoder;
+
+
+    /**
+     * Computes the gap-encoded list of prime numbers up to the n-th.
+     * @details segmented Eratosthenes sieve, the primes are never stored as an array of long long int.
+     * @details 2 -> 3 is stored as half-gap 0, every other gap is even and is stored halved.
+     *
+     * @param n the maximum number within which to search for prime numbers.
+     * @param checkpointInterval the number of primes between two absolute checkpoints.
+     * @return the gap-encoded list of prime numbers up to the n-th.
+     */
+    compressedPrimeList *compressedPrimeNumberList(long long int n, long long int checkpointInterval);
+
+    /**
+     * Searches for the index-th prime number of a gap-encoded list.
+     * @details jumps to the nearest checkpoint and decodes at most checkpointInterval gaps.
+     * @warning index must be lower than the list size.
+     *
+     * @param list the gap-encoded list.
+     * @param index the position of the prime number, starting from 0.
+     * @return the index-th prime number of the list.
+     */
+    long long int compressedPrimeAt(compressedPrimeList *list, long long int index);
+
+    /**
+     * Saves a gap-encoded list of prime numbers to a file.
+     *
+     * @param list the gap-encoded list.
+     * @param fileName the name of the file.
+     */
+    void saveCompressedPrimeList(compressedPrimeList *list, const char *fileName);
+
+    /**
+     * Loads a gap-encoded list of prime numbers from a file.
+     * @warning the file must have been written by saveCompressedPrimeList.
+     *
+     * @param fileName the name of the file.
+     * @return the gap-encoded list.
+     */
+    compressedPrimeList *loadCompressedPrimeList(const char *fileName);
+
+    /**
+     * Deletes a gap-encoded list of prime numbers.
+     *
+     * @param list the gap-encoded list to be deleted.
+     */
+    void deleteCompressedPrimeList(compressedPrimeList *list);
+
+    /**
+     * Creates a streaming decoder over a gap-encoded list of prime numbers.
+     * @warning index must be lower than or equal to the list size.
+     *
+     * @param list the gap-encoded list.
+     * @param index the index of the first prime to decode.
+     * @return the decoder.
+     */
+    compressedPrimeDecoder *createCompressedPrimeDecoder(compressedPrimeList *list, long long int index);
+
+    /**
+     * Decodes the next prime numbers of a gap-encoded list.
+     * @details the gaps of the block are first unpacked, then prefix-summed into the buffer.
+     *
+     * @param decoder the decoder.
+     * @param buffer the list where the prime numbers are written.
+     * @param bufferSize the maximum number of prime numbers to decode.
+     * @return the number of prime numbers decoded, 0 when the list is over.
+     */
+    long long int decodeCompressedPrimes(compressedPrimeDecoder *decoder, long long int *buffer, long long int bufferSize);
+
+    /**
+     * Deletes a streaming decoder.
+     *
+     * @param decoder the decoder to be deleted.
+     */
+    void deleteCompressedPrimeDecoder(compressedPrimeDecoder *decoder);
+
+
+    //******************************************************************************************************************//
+
+
+    //**********************//
+    //  DISCRETE LOGARITHM  //
+    //**********************//
+
+
+    /**
+     * Struct --> represents the baby-step table of a base modulo m, reusable for many discrete logarithms.
+     *
+     * @details base - the logarithm base.
+     * @details m - the module value.
+     * @details order - the upper bound of the logarithms searched, usually the order of base.
+     * @details babySteps - the number of baby steps stored - base^j (mod m) 0<=j<babySteps.
+     * @details giantStep - the value of base^(-babySteps) (mod m).
+     * @details table - the baby steps keyed by residue.
+     */
+    typedef struct DiscreteLogarithmTable {
+        long long int base;
+        long long int m;
+        long long int order;
+        long long int babySteps;
+        long long int giantStep;
+        hashTable *table;
+    }discreteLogarithmTable;
+
+
+    /**
+     * Creates the baby-step table of a base modulo m.
+     * @details with T baby steps, every logarithm takes at most order/T giant steps.
+     * @details T is the largest value whose hash table fits in memoryBudget bytes, never more than order.
+     * @details if memoryBudget is 0, T = sqrt(order) rounded up.
+     * @warning base must be coprime with m.
+     *
+     * @param base the logarithm base.
+     * @param m the module value.
+     * @param order the upper bound of the logarithms searched, m - 1 if base is a primitive root modulo a prime m.
+     * @param memoryBudget the maximum number of bytes used by the table, 0 for the square root default.
+     * @return the baby-step table.
+     */
+    discreteLogarithmTable *createDiscreteLogarithmTable(long long int base, long long int m, long long int order, long long int memoryBudget);
+
+    /**
+     * Computes the discrete logarithm of a number using a baby-step table.
+     * @details Baby-Step Giant-Step algorithm.
+     * @details b = base^x (mod m) where x = Log_(base) (b) and 0 <= x < order.
+     *
+     * @param table the baby-step table.
+     * @param b the number.
+     * @return the discrete logarithm, -1 if it does not exist.
+     */
+    long long int discreteLogarithmFromTable(discreteLogarithmTable *table, long long int b);
+
+    /**
+     * Computes the discrete logarithms of many numbers using a baby-step table.
+     * @details Baby-Step Giant-Step algorithm.
+     *
+     * @param table the baby-step table.
+     * @param numberOfValues the number of numbers.
+     * @param b the numbers.
+     * @param res the discrete logarithms, -1 where it does not exist.
+     */
+    void discreteLogarithmBatch(discreteLogarithmTable *table, long long int numberOfValues, long long int *b, long long int *res);
+
+    /**
+     * Saves a baby-step table to a file.
+     *
+     * @param table the baby-step table.
+     * @param fileName the name of the file.
+     */
+    void saveDiscreteLogarithmTable(discreteLogarithmTable *table, const char *fileName);
+
+    /**
+     * Loads a baby-step table from a file.
+     * @warning the file must have been written by saveDiscreteLogarithmTable.
+     *
+     * @param fileName the name of the file.
+     * @return the baby-step table.
+     */
+    discreteLogarithmTable *loadDiscreteLogarithmTable(const char *fileName);
+
+    /**
+     * Deletes a baby-step table.
+     *
+     * @param table the baby-step table to be deleted.
+     */
+    void deleteDiscreteLogarithmTable(discreteLogarithmTable *table);
+
+    /**
+     * Computes the discrete logarithm modulo m of base number.
+     * @details Pohlig-Hellman algorithm: the logarithm is computed modulo every prime power q^e dividing the order,
+     * @details one base-q digit at a time in the subgroup of order q,
+     * @details with Baby-Step Giant-Step or, when q is too large for its table, with Pollard's rho,
+     * @details then the results are combined with the Chinese Reminder Theorem.
+     * @details O(sum(e * sqrt(q))) multiplications, fast when the order is smooth.
+     * @details b = base^x (mod m) where x = Log_(base) (b) and 0 <= x < order.
+     * @warning order must be the multiplicative order of base modulo m, m - 1 if base is a primitive root modulo a prime m.
+     *
+     * @param base the logarithm base.
+     * @param b the number.
+     * @param m the module value.
+     * @param order the multiplicative order of base modulo m.
+     * @return the discrete logarithm modulo order, -1 if it does not exist.
+     */
+    long long int PohligHellmanAlgorithm(long long int base, long long int b, long long int m, long long int order);
+
+    /**
+     * Computes the discrete logarithm modulo m of base number.
+     * @details Pollard's rho algorithm with Brent's cycle detection, O(sqrt(order)) multiplications and O(1) memory.
+     * @details Teske's r-adding walk: x = base^u * b^v is multiplied by one of 20 random base^a * b^c chosen from a hash of x.
+     * @details a collision gives u1 + x*v1 == u2 + x*v2 (mod order), solved for every gcd(v2 - v1, order) candidate.
+     * @details b = base^x (mod m) where x = Log_(base) (b) and 0 <= x < order.
+     * @warning order must be the multiplicative order of base modulo m, best when it is prime.
+     *
+     * @param base the logarithm base.
+     * @param b the number.
+     * @param m the module value.
+     * @param order the multiplicative order of base modulo m.
+     * @return the discrete logarithm modulo order, -1 if it does not exist.
+     */
+    long long int PollardRhoAlgorithm(long long int base, long long int b, long long int m, long long int order);
+
+    /**
+     * Computes the discrete logarithm modulo m of base number, knowing that it lies in an interval.
+     * @details Pollard's kangaroo (lambda) algorithm, O(sqrt(upper - lower)) multiplications and O(log(upper - lower)) memory.
+     * @details a tame kangaroo jumps from base^upper and sets a trap, a wild kangaroo jumps from b until it falls in it.
+     * @details the jumps are powers of 2 chosen from a hash of the position, with mean sqrt(upper - lower) / 2.
+     * @details b = base^x (mod m) where x = Log_(base) (b) and lower <= x <= upper.
+     *
+     * @param base the logarithm base.
+     * @param b the number.
+     * @param m the module value.
+     * @param lower the smallest possible logarithm.
+     * @param upper the largest possible logarithm.
+     * @return the discrete logarithm, -1 if it was not found in the interval.
+     */
+    long long int PollardKangarooAlgorithm(long long int base, long long int b, long long int m, long long int lower, long long int upper);
+
+
+    /**
+     * Struct --> represents the progress of a parallel discrete logarithm.
+     *
+     * @details steps - the number of walk steps made by all the threads.
+     * @details distinguishedPoints - the number of distinguished points stored in the shared table.
+     * @details collisions - the number of distinguished points reached by two different walks.
+     * @details seconds - the time elapsed since the start.
+     * @details stepsPerSecond - the throughput of all the threads.
+     */
+    typedef struct ParallelLogarithmStatistics {
+        long long int steps;
+        long long int distinguishedPoints;
+        long long int collisions;
+        double seconds;
+        double stepsPerSecond;
+    }parallelLogarithmStatistics;
+
+
+    /**
+     * Computes the discrete logarithm modulo m of base number using many threads.
+     * @details parallel Pollard's rho algorithm with distinguished points (van Oorschot-Wiener).
+     * @details every thread runs the same r-adding walk from random starting points and stores the points x with
+     * @details (x & distinguishedMask) == 0 in a lock-free hash table shared by all the threads:
+     * @details two walks that merge reach the same distinguished point and their exponents give the logarithm.
+     * @details b = base^x (mod m) where x = Log_(base) (b) and 0 <= x < order.
+     * @warning order must be the multiplicative order of base modulo m, best when it is prime.
+     *
+     * @param base the logarithm base.
+     * @param b the number.
+     * @param m the module value.
+     * @param order the multiplicative order of base modulo m.
+     * @param numberOfThreads the number of threads.
+     * @param distinguishedMask the mask of the bits that must be 0 in a distinguished point, e.g. (1 << 12) - 1.
+     * @param progress the function called about once per second with the current statistics - NOT necessary.
+     * @param statistics the final statistics - NOT necessary.
+     * @return the discrete logarithm modulo order, -1 if it does not exist.
+     */
+    long long int parallelDiscreteLogarithm(long long int base, long long int b, long long int m, long long int order,
+                                            int numberOfThreads, long long int distinguishedMask,
+                                            void (*progress)(parallelLogarithmStatistics *statistics),
+                                            parallelLogarithmStatistics *statistics);
+
+
+    //******************************************************************************************************************//
+
+
+    //******************//
+    //  INDEX CALCULUS  //
+    //******************//
+
+
+    /**
+     * Struct --> represents the precomputation of the index-calculus discrete logarithm modulo a prime.
+     *
+     * @details base - the logarithm base, a primitive root modulo p.
+     * @details p - the prime module value.
+     * @details order - the order of the group, p - 1.
+     * @details largeModulus - the product of the prime powers of the order solved by linear algebra.
+     * @details smallModulus - order / largeModulus, solved by Pohlig-Hellman at every query.
+     * @details factorBase - the small primes whose logarithms are precomputed.
+     * @details factorBaseSize - the number of primes in the factor base.
+     * @details logarithm - the logarithms of the factor base modulo largeModulus, -1 if unknown.
+     * @details relations - the number of relations collected.
+     */
+    typedef struct IndexCalculus {
+        long long int base;
+        long long int p;
+        long long int order;
+        long long int largeModulus;
+        long long int smallModulus;
+        long long int *factorBase;
+        long long int factorBaseSize;
+        long long int *logarithm;
+        long long int relations;
+    }indexCalculus;
+
+
+    /**
+     * Creates the index-calculus precomputation of a base modulo a prime.
+     * @details relation collection: base^k (mod p) for random k is kept when it factors over the factor base,
+     * @details so k == sum(e_i * log(p_i)) (mod p - 1); the threads share the random search.
+     * @details linear algebra: the relations are solved modulo every prime power of p - 1 above 2^24
+     * @details by sparse Gauss-Jordan elimination, every logarithm found is verified in its subgroup.
+     * @details the prime powers of p - 1 below 2^24 are left to Pohlig-Hellman at query time.
+     * @warning p must be a prime number and base a primitive root modulo p.
+     *
+     * @param base the logarithm base.
+     * @param p the prime module value.
+     * @param factorBaseSize the number of small primes in the factor base.
+     * @param numberOfThreads the number of threads collecting relations.
+     * @return the index-calculus precomputation.
+     */
+    indexCalculus *createIndexCalculus(long long int base, long long int p, long long int factorBaseSize, int numberOfThreads);
+
+    /**
+     * Computes the discrete logarithm modulo p of base number using the index-calculus precomputation.
+     * @details individual logarithm: b * base^s (mod p) for random s until it factors over the factor base (no special-q descent),
+     * @details then log(b) == sum(e_i * log(p_i)) - s (mod largeModulus).
+     * @details the residue modulo smallModulus comes from Pohlig-Hellman, the two are combined with the Chinese Reminder Theorem.
+     * @details b = base^x (mod p) where x = Log_(base) (b).
+     *
+     * @param context the index-calculus precomputation.
+     * @param b the number.
+     * @return the discrete logarithm modulo p - 1, -1 if b is 0 modulo p.
+     */
+    long long int indexCalculusLogarithm(indexCalculus *context, long long int b);
+
+    /**
+     * Deletes an index-calculus precomputation.
+     *
+     * @param context the index-calculus precomputation to be deleted.
+     */
+    void deleteIndexCalculus(indexCalculus *context);
+
+
+    //******************************************************************************************************************//
+
+
+    //*****************//
+    //  MODULAR ROOTS  //
+    //*****************//
+
+
+    /**
+     * Struct --> represents the precomputation of the square roots modulo a prime, reusable for many numbers.
+     *
+     * @details p - the prime module value.
+     * @details q - the odd part of p - 1.
+     * @details s - the 2-adic valuation of p - 1, p - 1 = q*2^s.
+     * @details nonResidue - the smallest quadratic non-residue modulo p.
+     * @details zq - the value of nonResidue^q (mod p).
+     * @details useCipolla - 1 if s is large enough for Cipolla-Lehmer to beat Tonelli-Shanks, 0 otherwise.
+     */
+    typedef struct SquareRootContext {
+        long long int p;
+        long long int q;
+        long long int s;
+        long long int nonResidue;
+        long long int zq;
+        int useCipolla;
+    }squareRootContext;
+
+
+    /**
+     * Creates the square-root precomputation modulo a prime.
+     * @details q and s come from the trailing zeros of p - 1, the non-residue from Euler's criterion.
+     * @details Tonelli-Shanks takes O(s^2) products against O(log p) for Cipolla-Lehmer, which is chosen when s^2 > 24 * log2(p).
+     * @warning p must be an odd prime number, it is not tested.
+     *
+     * @param p the prime module value.
+     * @return the square-root precomputation.
+     */
+    squareRootContext *createSquareRootContext(long long int p);
+
+    /**
+     * Computes a square root modulo p of a number using the square-root precomputation.
+     * @details Tonelli-Shanks algorithm, the order of t is found by repeated squaring.
+     * @details Cipolla-Lehmer algorithm when the 2-adic valuation of p - 1 makes Tonelli-Shanks too slow.
+     * @details the other square root is p - res.
+     *
+     * @param context the square-root precomputation.
+     * @param a the number whose square root is to be calculated.
+     * @return a square root modulo p of the number, -1 if a is not a quadratic residue modulo p.
+     */
+    long long int squareRootFromContext(squareRootContext *context, long long int a);
+
+    /**
+     * Computes the square roots modulo p of a number.
+     * @details Cipolla-Lehmer algorithm.
+     * @details two different result (+res && -res)
+     * @warning p must be an odd prime number, it is not tested.
+     *
+     * @param a the number whose square root is to be calculated.
+     * @param p the module value.
+     * @return the square roots modulo p of the number, NULL if a is not a quadratic residue modulo p.
+     */
+    long long int *CipollaAlgorithm(long long int a, long long int p);
+
+    /**
+     * Computes a square root modulo p of many numbers using the square-root precomputation.
+     * @details Tonelli-Shanks or Cipolla-Lehmer algorithm, as chosen by the precomputation.
+     *
+     * @param context the square-root precomputation.
+     * @param numberOfValues the number of numbers.
+     * @param a the numbers whose square roots are to be calculated.
+     * @param res a square root of every number, -1 where it is not a quadratic residue.
+     */
+    void squareRootBatch(squareRootContext *context, long long int numberOfValues, long long int *a, long long int *res);
+
+    /**
+     * Deletes a square-root precomputation.
+     *
+     * @param context the square-root precomputation to be deleted.
+     */
+    void deleteSquareRootContext(squareRootContext *context);
+
+    /**
+     * Computes all the square roots modulo m of a number.
+     * @details m is factorised, the roots modulo every prime power come from Tonelli-Shanks (or Cipolla-Lehmer) and Hensel lifting,
+     * @details with the special lifting for 2^k, and every combination is merged with the Chinese Reminder Theorem.
+     * @details the roots are sorted when all of them fit in res, call with size 0 to get their number.
+     *
+     * @param a the number whose square roots are to be calculated.
+     * @param m the module value.
+     * @param res the square roots, can be NULL if size is 0.
+     * @param size the number of roots res can hold.
+     * @return the number of square roots modulo m, 0 if a is not a quadratic residue modulo m.
+     */
+    long long int allSquareRoots(long long int a, long long int m, long long int *res, long long int size);
+
+    /**
+     * Computes all the k-th roots modulo m of a number.
+     * @details the units modulo an odd prime power are cyclic: the equation is split on their Sylow subgroups (Adleman-Manders-Miller),
+     * @details the units modulo 2^f are ±5^c; the non-units are reduced to units by the p-adic valuation of a.
+     * @details the roots modulo every prime power are combined with the Chinese Reminder Theorem.
+     * @details the factorisations of m and φ(m) come from the descriptor, so many roots modulo the same m are cheap.
+     * @details the roots are sorted when all of them fit in res, call with size 0 to get their number.
+     *
+     * @param a the number whose k-th roots are to be calculated.
+     * @param k the exponent of the root.
+     * @param descriptor the descriptor of the module value.
+     * @param res the k-th roots, can be NULL if size is 0.
+     * @param size the number of roots res can hold.
+     * @return the number of k-th roots modulo m, 0 if a is not a k-th power modulo m.
+     */
+    long long int allKthRoots(long long int a, long long int k, modulusDescriptor *descriptor, long long int *res, long long int size);
+
+    /**
+     * Computes the k-th roots modulo m of a number.
+     * @details see allKthRoots.
+     * @warning a must be a k-th power modulo m.
+     *
+     * @param a the number whose k-th roots are to be calculated.
+     * @param k the exponent of the root.
+     * @param m the module value.
+     * @param numberOfRoots the number of k-th roots.
+     * @return the k-th roots modulo m of the number, sorted.
+     */
+    long long int *kthRoot(long long int a, long long int k, long long int m, long long int *numberOfRoots);
+
+
+    /**
+     * Struct --> represents the quadratic residues modulo n, one bit per number.
+     *
+     * @details n - the module value.
+     * @details bits - bit a of the bitmap is 1 iff a is a quadratic residue modulo n.
+     * @details words - the number of 64-bit words of the bitmap.
+     */
+    typedef struct QuadraticResidueBitmap {
+        long long int n;
+        unsigned long long int *bits;
+        long long int words;
+    }quadraticResidueBitmap;
+
+
+    /**
+     * Creates the quadratic residue bitmap modulo n.
+     * @details the squares are marked from i = 0 to n/2 with (i+1)^2 = i^2 + 2i + 1, without any product, in O(n) time and n bits.
+     * @details 0 and the squares not coprime with n are residues too, as a == x^2 (mod n) has a solution.
+     *
+     * @param n the module value.
+     * @return the quadratic residue bitmap.
+     */
+    quadraticResidueBitmap *createQuadraticResidueBitmap(long long int n);
+
+    /**
+     * Creates the quadratic residue bitmap modulo n from its prime-power components.
+     * @details a is a residue modulo n iff it is a residue modulo every p^e (Chinese Reminder Theorem),
+     * @details so only the bitmaps of the prime powers are built by squaring, then every a is tested on its residues.
+     *
+     * @param descriptor the descriptor of the module value.
+     * @return the quadratic residue bitmap.
+     */
+    quadraticResidueBitmap *createQuadraticResidueBitmapFromFactors(modulusDescriptor *descriptor);
+
+    /**
+     * Checks if a number is a quadratic residue using the bitmap.
+     * @details O(1) bit test.
+     *
+     * @param bitmap the quadratic residue bitmap.
+     * @param a the number.
+     * @return 1 if a is a quadratic residue modulo n, 0 otherwise.
+     */
+    int isQuadraticResidue(quadraticResidueBitmap *bitmap, long long int a);
+
+    /**
+     * Counts the quadratic residues lower than a bound using the bitmap.
+     * @details hardware popcount on every 64-bit word.
+     *
+     * @param bitmap the quadratic residue bitmap.
+     * @param upper the bound, at most n.
+     * @return the number of quadratic residues in [0, upper).
+     */
+    long long int countQuadraticResidues(quadraticResidueBitmap *bitmap, long long int upper);
+
+    /**
+     * Deletes a quadratic residue bitmap.
+     *
+     * @param bitmap the bitmap to be deleted.
+     */
+    void deleteQuadraticResidueBitmap(quadraticResidueBitmap *bitmap);
+
+
+    //******************************************************************************************************************//
+
+
+    //*************************//
+    //  RESIDUE NUMBER SYSTEM  //
+    //*************************//
+
+
+    /**
+     * Struct --> represents the basis of a residue number system: a number is represented by its residues modulo every prime.
+     *
+     * @details size - the number of primes.
+     * @details prime - the primes, lower than 2^31 and decreasing.
+     * @details barrett - the Barrett constant floor(2^64 / p) of every prime.
+     * @details crt - the Garner precomputation of the primes, to convert residues back to words.
+     */
+    typedef struct RnsBasis {
+        long long int size;
+        long long int *prime;
+        unsigned long long int *barrett;
+        crtContext *crt;
+    }rnsBasis;
+
+
+    /**
+     * Creates a basis of a residue number system.
+     * @details the basis is made of the largest primes below bound, found with the Miller-Rabin test,
+     * @details so the residues of a number fit in 32 bits and the product of two of them in 64 bits.
+     *
+     * @param size the number of primes of the basis.
+     * @param bound the upper bound of the primes, excluded, at most 2^31.
+     * @return the basis.
+     */
+    rnsBasis *createRnsBasis(long long int size, long long int bound);
+
+    /**
+     * Computes the residues of a number in a residue number system.
+     *
+     * @param basis the basis of the residue number system.
+     * @param n the number.
+     * @param res the residues, one per prime of the basis.
+     */
+    void rnsFromInteger(rnsBasis *basis, unsigned long long int n, long long int *res);
+
+    /**
+     * Computes the residues of a multi-word number in a residue number system.
+     * @details Horner's rule on the words, from the most significant: r = r * 2^64 + w (mod p).
+     *
+     * @param basis the basis of the residue number system.
+     * @param numberOfWords the number of 64-bit words of the number.
+     * @param words the number, least significant word first.
+     * @param res the residues, one per prime of the basis.
+     */
+    void rnsFromWords(rnsBasis *basis, long long int numberOfWords, unsigned long long int *words, long long int *res);
+
+    /**
+     * Computes the number represented by residues in a residue number system.
+     * @details Garner's algorithm on the Chinese Reminder Theorem precomputation of the basis.
+     *
+     * @param basis the basis of the residue number system.
+     * @param x the residues.
+     * @param res the number modulo the product of the primes, basis->crt->words 64-bit words, least significant first.
+     */
+    void rnsToWords(rnsBasis *basis, long long int *x, unsigned long long int *res);
+
+    /**
+     * Computes the sum in a residue number system.
+     * @details every residue is independent: no carry.
+     *
+     * @param basis the basis of the residue number system.
+     * @param x the residues of the first addend.
+     * @param y the residues of the second addend.
+     * @param res the residues of the sum, it may be x or y.
+     */
+    void rnsSum(rnsBasis *basis, long long int *x, long long int *y, long long int *res);
+
+    /**
+     * Computes the difference in a residue number system.
+     * @details every residue is independent: no borrow.
+     *
+     * @param basis the basis of the residue number system.
+     * @param x the residues of the minuend.
+     * @param y the residues of the subtrahend.
+     * @param res the residues of the difference, it may be x or y.
+     */
+    void rnsSub(rnsBasis *basis, long long int *x, long long int *y, long long int *res);
+
+    /**
+     * Computes the product in a residue number system.
+     * @details every residue is independent: one Barrett product per prime, no carry.
+     *
+     * @param basis the basis of the residue number system.
+     * @param x the residues of the first factor.
+     * @param y the residues of the second factor.
+     * @param res the residues of the product, it may be x or y.
+     */
+    void rnsProduct(rnsBasis *basis, long long int *x, long long int *y, long long int *res);
+
+    /**
+     * Computes the residues of a number in another residue number system.
+     * @details base extension: the mixed-radix digits v_i of the number come from Garner's algorithm in the first basis,
+     * @details then x = v_0 + m_0 * (v_1 + m_1 * (...)) is evaluated by Horner's rule modulo every prime of the second basis.
+     *
+     * @param from the basis of the residues.
+     * @param x the residues in the first basis.
+     * @param to the basis of the result.
+     * @param res the residues in the second basis, the number modulo the product of the primes of the first basis.
+     */
+    void rnsBaseExtension(rnsBasis *from, long long int *x, rnsBasis *to, long long int *res);
+
+    /**
+     * Deletes a basis of a residue number system.
+     *
+     * @param basis the basis to be deleted.
+     */
+    void deleteRnsBasis(rnsBasis *basis);
+
+
+    //******************************************************************************************************************//
+
+
+    //*************************//
+    //  MULTI-WORD ARITHMETIC  //
+    //*************************//
+
+
+    /**
+     * Declares the fixed-width multi-word modular arithmetic of a width, generated for 128, 256 and 512 bits.
+     * @details the functions are generated per width, so the word loops run a constant number of times and are unrolled.
+     * @details uBITS - an unsigned number of BITS / 64 words, least significant first.
+     * @details montgomeryBITS - the Montgomery precomputation of an odd module value m: the radix R = 2^BITS,
+     * @details R^2 (mod m), R (mod m) - the Montgomery form of 1, and -m^(-1) (mod 2^64).
+     *
+     * @details uBITS uBITSFromInteger(n) - the number n.
+     * @details uBITS uBITSFromHex(hex) - the number written in hexadecimal digits, with or without 0x.
+     * @details void uBITSToHex(a, res) - writes the BITS / 4 hexadecimal digits of a and the terminator in res.
+     * @details int uBITSCompare(a, b) - 1 if a > b, -1 if a < b, 0 if they are equal.
+     *
+     * @details createMontgomeryBITS(m), deleteMontgomeryBITS(context) - the Montgomery precomputation, m odd and greater than 1.
+     * @details toMontgomeryBITS(context, a), fromMontgomeryBITS(context, a) - a * R (mod m) and a * R^(-1) (mod m).
+     * @details montgomeryProductBITS(context, a, b) - a * b * R^(-1) (mod m), coarsely integrated operand scanning.
+     * @details montgomeryPowerBITS(context, a, exp) - a^exp in Montgomery form, a in Montgomery form, 4-bit fixed window.
+     *
+     * @details sumBITS(a, b, m), subBITS(a, b, m) - the sum and the difference modulo m, a and b must be lower than m.
+     * @details productBITSFromContext(context, a, b), powerBITSFromContext(context, a, exp) - the product and the power
+     * @details elevation of numbers lower than m, not in Montgomery form, with the precomputation of m: use them for many
+     * @details operations modulo the same m.
+     * @details productBITS(a, b, m), powerBITS(a, exp, m) - the same, the precomputation is computed on every call.
+     * @details modularInverseBITS(a, m) - the inverse of a < m modulo an odd m, binary extended Euclidean algorithm.
+     * @details isPrimeBITS(n) - the Miller-Rabin test to the first 20 prime bases, deterministic below 3.3 * 10^24.
+     * @details squareRootBITS(a, p, res) - a square root of a < p modulo an odd prime p with the Tonelli-Shanks algorithm,
+     * @details the other one is p - res; it returns 1 if a is a quadratic residue modulo p, 0 otherwise.
+     *
+     * @param BITS the width, 128, 256 or 512.
+     */
+    #define MULTI_WORD_DECLARATIONS(BITS)                                                                                \
+        typedef struct U##BITS {                                                                                         \
+            unsigned long long int word[BITS / 64];                                                                      \
+        }u##BITS;                                                                                                        \
+                                                                                                                         \
+        typedef struct Montgomery##BITS {                                                                                \
+            u##BITS m;                                                                                                   \
+            u##BITS r2;                                                                                                  \
+            u##BITS one;                                                                                                 \
+            unsigned long long int inverse;                                                                              \
+        }montgomery##BITS;                                                                                               \
+                                                                                                                         \
+        u##BITS u##BITS##FromInteger(unsigned long long int n);                                                          \
+        u##BITS u##BITS##FromHex(const char *hex);                                                                       \
+        void u##BITS##ToHex(u##BITS a, char *res);                                                                       \
+        int u##BITS##Compare(u##BITS a, u##BITS b);                                                                      \
+                                                                                                                         \
+        montgomery##BITS *createMontgomery##BITS(u##BITS m);                                                             \
+        u##BITS toMontgomery##BITS(montgomery##BITS *context, u##BITS a);                                                \
+        u##BITS fromMontgomery##BITS(montgomery##BITS *context, u##BITS a);                                              \
+        u##BITS montgomeryProduct##BITS(montgomery##BITS *context, u##BITS a, u##BITS b);                                \
+        u##BITS montgomeryPower##BITS(montgomery##BITS *context, u##BITS a, u##BITS exp);                                \
+        void deleteMontgomery##BITS(montgomery##BITS *context);                                                          \
+                                                                                                                         \
+        u##BITS sum##BITS(u##BITS a, u##BITS b, u##BITS m);                                                              \
+        u##BITS sub##BITS(u##BITS a, u##BITS b, u##BITS m);                                                              \
+        u##BITS product##BITS(u##BITS a, u##BITS b, u##BITS m);                                                          \
+        u##BITS power##BITS(u##BITS a, u##BITS exp, u##BITS m);                                                          \
+        u##BITS product##BITS##FromContext(montgomery##BITS *context, u##BITS a, u##BITS b);                             \
+        u##BITS power##BITS##FromContext(montgomery##BITS *context, u##BITS a, u##BITS exp);                             \
+        u##BITS modularInverse##BITS(u##BITS a, u##BITS m);                                                              \
+        int isPrime##BITS(u##BITS n);                                                                                    \
+        int squareRoot##BITS(u##BITS a, u##BITS p, u##BITS *res);
+
+    MULTI_WORD_DECLARATIONS(128)
+    MULTI_WORD_DECLARATIONS(256)
+    MULTI_WORD_DECLARATIONS(512)
+
+
+    //******************************************************************************************************************//
+
+
+    //******************************//
+    //  NUMBER-THEORETIC TRANSFORM  //
+    //******************************//
+
+
+    /**
+     * Struct --> represents the precomputation of the number-theoretic transform modulo a prime p = c * 2^k + 1.
+     *
+     * @details p - the prime, lower than 2^64, e.g. 998244353 or 2^64 - 2^32 + 1.
+     * @details maxLength - the largest length of a transform, a power of 2 dividing p - 1.
+     * @details g - a primitive root modulo p.
+     * @details inverse - p^(-1) (mod 2^64), for the Montgomery reduction.
+     * @details one - 2^64 (mod p), the Montgomery form of 1.
+     * @details r2 - 2^128 (mod p), to convert to the Montgomery form.
+     * @details root - the roots w_(2h)^j of every stage at h + j, [0] direct and [1] inverse, in Montgomery form.
+     * @details root3 - the roots w_(4m)^(3j) of every radix-4 stage at m + j, [0] direct and [1] inverse, in Montgomery form.
+     * @details unity - the fourth root of unity w_4, [0] direct and [1] inverse, in Montgomery form.
+     */
+    typedef struct NttContext {
+        unsigned long long int p;
+        long long int maxLength;
+        unsigned long long int g;
+        unsigned long long int inverse;
+        unsigned long long int one;
+        unsigned long long int r2;
+        unsigned long long int *root[2];
+        unsigned long long int *root3[2];
+        unsigned long long int unity[2];
+    }nttContext;
+
+
+    /**
+     * Creates the precomputation of the number-theoretic transform modulo a prime.
+     * @details the roots w_(2h)^j of every stage are stored at h + j, their cubes w_(4m)^(3j) at m + j, both in Montgomery form,
+     * @details computed from a primitive root g as w_n = g^((p-1)/n); the same for the inverse roots.
+     * @warning p must be an odd prime, maxLength a power of 2 dividing p - 1.
+     *
+     * @param p the prime, e.g. 998244353 = 119 * 2^23 + 1 or 2^64 - 2^32 + 1.
+     * @param maxLength the largest length of a transform.
+     * @return the precomputation.
+     */
+    nttContext *createNttContext(unsigned long long int p, long long int maxLength);
+
+    /**
+     * Computes the number-theoretic transform.
+     * @details radix-4 decimation in frequency with Montgomery twiddle products, one radix-2 stage first if log2(n) is odd.
+     * @details the result is in bit-reversed order, as needed by nttPointwiseProduct and nttInverse.
+     *
+     * @param context the precomputation.
+     * @param a the values, lower than p, transformed in place.
+     * @param n the length, a power of 2 not greater than maxLength.
+     */
+    void nttForward(nttContext *context, unsigned long long int *a, long long int n);
+
+    /**
+     * Computes the inverse number-theoretic transform.
+     * @details radix-4 decimation in time with the inverse roots, then every value is divided by n.
+     *
+     * @param context the precomputation.
+     * @param a the values in bit-reversed order, lower than p, transformed in place.
+     * @param n the length, a power of 2 not greater than maxLength.
+     */
+    void nttInverse(nttContext *context, unsigned long long int *a, long long int n);
+
+    /**
+     * Computes the pointwise product of two transforms.
+     *
+     * @param context the precomputation.
+     * @param a the first transform.
+     * @param b the second transform.
+     * @param res the pointwise product, it may be a or b.
+     * @param n the length.
+     */
+    void nttPointwiseProduct(nttContext *context, unsigned long long int *a, unsigned long long int *b, unsigned long long int *res,
+                             long long int n);
+
+    /**
+     * Computes the convolution of two sequences modulo the prime.
+     * @details res_k = sum(a_i * b_(k-i)): the sequences are padded to the next power of 2 n >= sizeA + sizeB - 1,
+     * @details transformed, multiplied pointwise and transformed back, O(n log n).
+     * @warning sizeA + sizeB - 1 must not be greater than maxLength.
+     *
+     * @param context the precomputation.
+     * @param a the first sequence, lower than p.
+     * @param sizeA the length of the first sequence.
+     * @param b the second sequence, lower than p.
+     * @param sizeB the length of the second sequence.
+     * @param res the convolution, sizeA + sizeB - 1 values; it may be a or b if it is large enough.
+     */
+    void nttConvolution(nttContext *context, unsigned long long int *a, long long int sizeA, unsigned long long int *b,
+                        long long int sizeB, unsigned long long int *res);
+
+    /**
+     * Deletes the precomputation of the number-theoretic transform.
+     *
+     * @param context the precomputation to be deleted.
+     */
+    void deleteNttContext(nttContext *context);
+
+
+    /**
+     * Struct --> represents the precomputation of the convolution modulo any m with three NTT primes.
+     *
+     * @details maxLength - the largest length of a transform, a power of 2 not greater than 2^55.
+     * @details transform - the precomputations of the transform modulo the three primes.
+     * @details crt - the Garner precomputation of the three primes, to recombine the coefficients.
+     */
+    typedef struct ConvolutionContext {
+        long long int maxLength;
+        nttContext *transform[3];
+        crtContext *crt;
+    }convolutionContext;
+
+
+    /**
+     * Creates the precomputation of the convolution modulo any m.
+     * @details the transform precomputations of the three NTT primes and their Garner precomputation,
+     * @details so many convolutions of length up to maxLength do not rebuild the roots.
+     *
+     * @param maxLength the largest length of a transform, a power of 2 not greater than 2^55.
+     * @return the precomputation.
+     */
+    convolutionContext *createConvolutionContext(long long int maxLength);
+
+    /**
+     * Computes the convolution of two sequences modulo any m using the precomputation of the three NTT primes.
+     * @details the exact coefficients are lower than min(sizeA, sizeB) * (m-1)^2 < 2^181, below the product of three NTT primes:
+     * @details the convolution is computed modulo every prime with the transforms, then the coefficients are recombined
+     * @details with Garner's algorithm and reduced modulo m, O(n log n); the schoolbook product is used for short sequences.
+     * @warning sizeA + sizeB - 1 must not be greater than maxLength, unless the schoolbook product is used.
+     *
+     * @param context the precomputation of the three primes.
+     * @param a the first sequence.
+     * @param sizeA the length of the first sequence.
+     * @param b the second sequence.
+     * @param sizeB the length of the second sequence.
+     * @param m the module value.
+     * @param res the convolution modulo m, sizeA + sizeB - 1 values; it may be a or b if it is large enough.
+     */
+    void convolutionFromContext(convolutionContext *context, long long int *a, long long int sizeA, long long int *b, long long int sizeB,
+                                long long int m, long long int *res);
+
+    /**
+     * Computes the convolution of two sequences modulo any m.
+     * @details see convolutionFromContext, the precomputation is built for this convolution only;
+     * @details use a convolutionContext for many convolutions.
+     *
+     * @param a the first sequence.
+     * @param sizeA the length of the first sequence.
+     * @param b the second sequence.
+     * @param sizeB the length of the second sequence.
+     * @param m the module value.
+     * @param res the convolution modulo m, sizeA + sizeB - 1 values; it may be a or b if it is large enough.
+     */
+    void convolutionModulo(long long int *a, long long int sizeA, long long int *b, long long int sizeB, long long int m, long long int *res);
+
+    /**
+     * Deletes the precomputation of the convolution modulo any m.
+     *
+     * @param context the precomputation to be deleted.
+     */
+    void deleteConvolutionContext(convolutionContext *context);
+
+
+    //******************************************************************************************************************//
+
+
+    //*************************//
+    //  POLYNOMIAL ARITHMETIC  //
+    //*************************//
+
+
+    /**
+     * Struct --> represents a polynomial modulo a prime, the operations take the NTT precomputation of the prime.
+     *
+     * @details size - the number of coefficients, the degree plus 1, 0 for the zero polynomial; the leading one is not 0.
+     * @details coefficient - the coefficients, lowest degree first, lower than p.
+     */
+    typedef struct Polynomial {
+        long long int size;
+        unsigned long long int *coefficient;
+    }polynomial;
+
+    /**
+     * Struct --> represents points modulo a prime with their subproduct tree, for many evaluations and interpolations.
+     *
+     * @details numberOfPoints - the number of points.
+     * @details x - the points, lower than p.
+     * @details tree - the subproduct tree, the node v stores the product of (x - x_i) for its segment, its children are 2v and 2v + 1.
+     * @details inverse - the inverse of the reversal of every node above the leaves, modulo x^(number of points of the node + 1).
+     * @details weight - the interpolation weights 1 / m'(x_i), NULL until the first interpolation.
+     */
+    typedef struct PolynomialPoints {
+        long long int numberOfPoints;
+        unsigned long long int *x;
+        polynomial **tree;
+        polynomial **inverse;
+        unsigned long long int *weight;
+    }polynomialPoints;
+
+
+    /**
+     * Creates a polynomial modulo a prime.
+     *
+     * @param size the number of coefficients.
+     * @param coefficient the coefficients, lowest degree first, lower than p; they are copied.
+     * @return the polynomial, without leading zero coefficients.
+     */
+    polynomial *createPolynomial(long long int size, unsigned long long int *coefficient);
+
+    /**
+     * Computes the sum of two polynomials modulo a prime.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param a the first polynomial.
+     * @param b the second polynomial.
+     * @return the sum.
+     */
+    polynomial *polynomialSum(nttContext *context, polynomial *a, polynomial *b);
+
+    /**
+     * Computes the difference of two polynomials modulo a prime.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param a the minuend.
+     * @param b the subtrahend.
+     * @return the difference.
+     */
+    polynomial *polynomialSub(nttContext *context, polynomial *a, polynomial *b);
+
+    /**
+     * Computes the product of two polynomials modulo a prime.
+     * @details the convolution of the coefficients with the transforms, O(n log n), or schoolbook for short polynomials.
+     * @warning the number of coefficients of the product must not be greater than the maxLength of the context.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param a the first polynomial.
+     * @param b the second polynomial.
+     * @return the product.
+     */
+    polynomial *polynomialProduct(nttContext *context, polynomial *a, polynomial *b);
+
+    /**
+     * Computes the inverse of a polynomial modulo x^n.
+     * @details Newton's iteration: g_(2k) = g_k * (2 - a * g_k) (mod x^(2k)) doubles the correct coefficients, O(n log n).
+     * @warning the constant coefficient must not be 0.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param a the polynomial.
+     * @param n the number of coefficients of the inverse.
+     * @return the polynomial g such that a * g = 1 (mod x^n).
+     */
+    polynomial *polynomialInverse(nttContext *context, polynomial *a, long long int n);
+
+    /**
+     * Computes the division with remainder of two polynomials modulo a prime.
+     * @details a = q * b + r with deg(r) < deg(b): the reversals satisfy rev(q) = rev(a) * rev(b)^(-1) (mod x^(deg(a) - deg(b) + 1)),
+     * @details so the quotient takes one Newton inverse and one product, O(n log n); schoolbook long division for short operands.
+     * @warning b must not be the zero polynomial.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param a the dividend.
+     * @param b the divisor.
+     * @param quotient the quotient, not computed if NULL.
+     * @param remainder the remainder, not computed if NULL.
+     */
+    void polynomialDivision(nttContext *context, polynomial *a, polynomial *b, polynomial **quotient, polynomial **remainder);
+
+    /**
+     * Computes the greatest common divisor of two polynomials modulo a prime.
+     * @details half-GCD algorithm: a Euclidean step, then the half-GCD matrix halves the degrees, O(n log^2 n).
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param a the first polynomial.
+     * @param b the second polynomial.
+     * @return the monic greatest common divisor, the zero polynomial if a and b are zero.
+     */
+    polynomial *polynomialGcd(nttContext *context, polynomial *a, polynomial *b);
+
+    /**
+     * Creates the subproduct tree of points modulo a prime, for many evaluations and interpolations at the same points.
+     * @details every node stores the product of its factors (x - x_i) and, above the leaves, the inverse of its reversal,
+     * @details so the divisions of the evaluations need no Newton iteration, O(n log^2 n).
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param numberOfPoints the number of points.
+     * @param x the points, lower than p; they are copied.
+     * @return the points with their subproduct tree.
+     */
+    polynomialPoints *createPolynomialPoints(nttContext *context, long long int numberOfPoints, unsigned long long int *x);
+
+    /**
+     * Evaluates a polynomial at many points modulo a prime using their subproduct tree.
+     * @details the remainders of the polynomial go down the tree, two products per node, O(n log^2 n).
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param points the points and their subproduct tree.
+     * @param a the polynomial.
+     * @param res the values a(x_i).
+     */
+    void polynomialEvaluateFromPoints(nttContext *context, polynomialPoints *points, polynomial *a, unsigned long long int *res);
+
+    /**
+     * Evaluates a polynomial at many points modulo a prime.
+     * @details see polynomialEvaluateFromPoints, the subproduct tree is built for this evaluation only.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param a the polynomial.
+     * @param numberOfPoints the number of points.
+     * @param x the points, lower than p.
+     * @param res the values a(x_i).
+     */
+    void polynomialEvaluate(nttContext *context, polynomial *a, long long int numberOfPoints, unsigned long long int *x,
+                            unsigned long long int *res);
+
+    /**
+     * Computes the interpolation polynomial of points modulo a prime using their subproduct tree.
+     * @details Lagrange's formula, the weights 1 / m'(x_i) are computed at the first interpolation and kept with the points, O(n log^2 n).
+     * @warning the points must be distinct.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param points the points and their subproduct tree.
+     * @param y the values, lower than p.
+     * @return the polynomial P of degree lower than numberOfPoints with P(x_i) = y_i.
+     */
+    polynomial *polynomialInterpolateFromPoints(nttContext *context, polynomialPoints *points, unsigned long long int *y);
+
+    /**
+     * Computes the interpolation polynomial of points modulo a prime.
+     * @details see polynomialInterpolateFromPoints, the subproduct tree is built for this interpolation only.
+     * @warning the points must be distinct.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param numberOfPoints the number of points.
+     * @param x the points, lower than p.
+     * @param y the values, lower than p.
+     * @return the polynomial P of degree lower than numberOfPoints with P(x_i) = y_i.
+     */
+    polynomial *polynomialInterpolate(nttContext *context, long long int numberOfPoints, unsigned long long int *x, unsigned long long int *y);
+
+    /**
+     * Deletes the subproduct tree of points.
+     *
+     * @param points the points to be deleted.
+     */
+    void deletePolynomialPoints(polynomialPoints *points);
+
+    /**
+     * Deletes a polynomial.
+     *
+     * @param a the polynomial to be deleted.
+     */
+    void deletePolynomial(polynomial *a);
+
+
+    //******************************************************************************************************************//
+
+
+    //*********************//
+    //  LINEAR RECURRENCE  //
+    //*********************//
+
+
+    /**
+     * Struct --> represents a linear recurrence s_n = c_1 * s_(n-1) + ... + c_d * s_(n-d) modulo a prime.
+     *
+     * @details order - the order d of the recurrence, 0 for the zero sequence.
+     * @details coefficient - the coefficients c_1, ..., c_d.
+     * @details initial - the initial terms s_0, ..., s_(d-1).
+     */
+    typedef struct LinearRecurrence {
+        long long int order;
+        unsigned long long int *coefficient;
+        unsigned long long int *initial;
+    }linearRecurrence;
+
+
+    /**
+     * Creates a linear recurrence s_n = c_1 * s_(n-1) + ... + c_d * s_(n-d) modulo a prime.
+     *
+     * @param order the order d of the recurrence.
+     * @param coefficient the coefficients c_1, ..., c_d, lower than p; they are copied.
+     * @param initial the initial terms s_0, ..., s_(d-1), lower than p; they are copied.
+     * @return the linear recurrence.
+     */
+    linearRecurrence *createLinearRecurrence(long long int order, unsigned long long int *coefficient, unsigned long long int *initial);
+
+    /**
+     * Finds the shortest linear recurrence that generates a sequence modulo a prime.
+     * @details Berlekamp-Massey algorithm, O(n^2). 2L terms determine a recurrence of order L.
+     *
+     * @param context the precomputation of the transform modulo p, only p is needed.
+     * @param numberOfTerms the number of terms.
+     * @param terms the terms s_0, s_1, ..., lower than p.
+     * @return the minimal linear recurrence, with the first terms as initial terms.
+     */
+    linearRecurrence *BerlekampMasseyAlgorithm(nttContext *context, long long int numberOfTerms, unsigned long long int *terms);
+
+    /**
+     * Computes a term of a linear recurrence modulo a prime.
+     * @details Fiduccia's algorithm: s_k = sum(r_i * s_i) with r = x^k modulo the characteristic polynomial,
+     * @details O(d log d log k) instead of the O(d^3 log k) of the power of the companion matrix.
+     * @warning 2d must not be greater than the maxLength of the context.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param recurrence the linear recurrence.
+     * @param k the index of the term.
+     * @return the term s_k.
+     */
+    unsigned long long int linearRecurrenceTerm(nttContext *context, linearRecurrence *recurrence, unsigned long long int k);
+
+    /**
+     * Computes many terms of a linear recurrence modulo a prime.
+     * @details Fiduccia's algorithm with shared squarings: x^(2^j) modulo the characteristic polynomial is computed once
+     * @details for every bit j of the largest index, then every x^k is the product of the powers of its bits.
+     * @warning 2d must not be greater than the maxLength of the context.
+     *
+     * @param context the precomputation of the transform modulo p.
+     * @param recurrence the linear recurrence.
+     * @param numberOfIndices the number of indices.
+     * @param k the indices of the terms.
+     * @param res the terms s_k.
+     */
+    void linearRecurrenceTerms(nttContext *context, linearRecurrence *recurrence, long long int numberOfIndices, unsigned long long int *k,
+                               unsigned long long int *res);
+
+    /**
+     * Deletes a linear recurrence.
+     *
+     * @param recurrence the linear recurrence to be deleted.
+     */
+    void deleteLinearRecurrence(linearRecurrence *recurrence);
+
 #endif
@@ -0,0 +1,417 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * The number of odd numbers analyzed by each segment of the sieve.
+ */
+#define SIEVE_SEGMENT_SIZE (1 << 18)
+
+/**
+ * The number of gaps unpacked at once by the decoder.
+ */
+#define DECODER_BLOCK_SIZE 256
+
+
+/**
+ * Appends a half-gap to a gap-encoded list of prime numbers.
+ * @details varbyte encoding: 7 bits per byte, the high bit marks that another byte follows.
+ *
+ * @param list the gap-encoded list.
+ * @param gapsCapacity the number of bytes allocated for the gaps.
+ * @param halfGap the half-gap to append.
+ */
+static void appendHalfGap(compressedPrimeList *list, long long int *gapsCapacity, long long int halfGap) {
+    //the longest varbyte of a long long int takes 10 bytes
+    if (list->gapsSize + 10 > *gapsCapacity) {
+        *gapsCapacity *= 2;
+        list->gaps = realloc(list->gaps, (*gapsCapacity) * sizeof(unsigned char));
+        assert(list->gaps != NULL);
+    }
+
+    while (halfGap >= 0x80) {
+        list->gaps[list->gapsSize++] = (unsigned char) ((halfGap & 0x7F) | 0x80);
+        halfGap >>= 7;
+    }
+    list->gaps[list->gapsSize++] = (unsigned char) halfGap;
+}
+
+/**
+ * Appends a prime number to a gap-encoded list of prime numbers.
+ *
+ * @param list the gap-encoded list.
+ * @param gapsCapacity the number of bytes allocated for the gaps.
+ * @param checkpointCapacity the number of checkpoints allocated.
+ * @param previous the last prime number appended.
+ * @param prime the prime number to append.
+ */
+static void appendPrime(compressedPrimeList *list, long long int *gapsCapacity, long long int *checkpointCapacity,
+                        long long int previous, long long int prime) {
+    //the first prime has no gap, every other one is stored as half-gap (2 -> 3 becomes 0)
+    if (list->size > 0) {
+        appendHalfGap(list, gapsCapacity, (prime - previous) / 2);
+    }
+
+    if (list->size % list->checkpointInterval == 0) {
+        if (list->checkpointSize == *checkpointCapacity) {
+            *checkpointCapacity *= 2;
+            list->checkpointValue = realloc(list->checkpointValue, (*checkpointCapacity) * sizeof(long long int));
+            assert(list->checkpointValue != NULL);
+            list->checkpointOffset = realloc(list->checkpointOffset, (*checkpointCapacity) * sizeof(long long int));
+            assert(list->checkpointOffset != NULL);
+        }
+        list->checkpointValue[list->checkpointSize] = prime;
+        list->checkpointOffset[list->checkpointSize] = list->gapsSize;
+        list->checkpointSize++;
+    }
+
+    list->size++;
+}
+
+/**
+ * Reads a half-gap from a gap-encoded list of prime numbers and converts it into a gap.
+ *
+ * @param gaps the varbyte encoded half-gaps.
+ * @param offset the position of the half-gap, updated to the position of the following one.
+ * @return the gap.
+ */
+static long long int readGap(const unsigned char *gaps, long long int *offset) {
+    //The half-gap.
+    long long int halfGap = 0;
+    //The position of the current 7 bits.
+    int shift = 0;
+
+    while (gaps[*offset] & 0x80) {
+        halfGap |= (long long int) (gaps[(*offset)++] & 0x7F) << shift;
+        shift += 7;
+    }
+    halfGap |= (long long int) gaps[(*offset)++] << shift;
+
+    //half-gap 0 only comes from 2 -> 3
+    return halfGap == 0 ? 1 : 2 * halfGap;
+}
+
+
+/**
+ * Computes the gap-encoded list of prime numbers up to the n-th.
+ * @details segmented Eratosthenes sieve, the primes are never stored as an array of long long int.
+ * @details 2 -> 3 is stored as half-gap 0, every other gap is even and is stored halved.
+ *
+ * @param n the maximum number within which to search for prime numbers.
+ * @param checkpointInterval the number of primes between two absolute checkpoints.
+ * @return the gap-encoded list of prime numbers up to the n-th.
+ */
+compressedPrimeList *compressedPrimeNumberList(long long int n, long long int checkpointInterval) {
+    assert(checkpointInterval > 0);
+
+    //The gap-encoded list.
+    compressedPrimeList *list = malloc(sizeof(compressedPrimeList));
+    assert(list != NULL);
+    //The number of bytes allocated for the gaps.
+    long long int gapsCapacity = 1024;
+    //The number of checkpoints allocated.
+    long long int checkpointCapacity = 16;
+    //The last prime number appended.
+    long long int previous = 0;
+    //The square root of n rounded down.
+    long long int root = 0;
+    //The sieve of the odd numbers up to the square root of n.
+    unsigned char *small = NULL;
+    //The odd prime numbers up to the square root of n.
+    long long int *basePrimes = NULL;
+    //The number of odd prime numbers up to the square root of n.
+    long long int basePrimesSize = 0;
+    //The sieve of the current segment: position i represents low + 2i.
+    unsigned char *segment = NULL;
+
+    list->gaps = malloc(gapsCapacity * sizeof(unsigned char));
+    assert(list->gaps != NULL);
+    list->checkpointValue = malloc(checkpointCapacity * sizeof(long long int));
+    assert(list->checkpointValue != NULL);
+    list->checkpointOffset = malloc(checkpointCapacity * sizeof(long long int));
+    assert(list->checkpointOffset != NULL);
+    list->gapsSize = 0;
+    list->checkpointSize = 0;
+    list->checkpointInterval = checkpointInterval;
+    list->size = 0;
+
+    if (n < 2) {
+        return list;
+    }
+
+    appendPrime(list, &gapsCapacity, &checkpointCapacity, previous, 2);
+    previous = 2;
+
+    //sieve the odd numbers up to the square root of n
+    while (root * root <= n) {
+        root++;
+    }
+    root--;
+    small = calloc(root + 1, sizeof(unsigned char));
+    assert(small != NULL);
+    basePrimes = malloc((root / 2 + 1) * sizeof(long long int));
+    assert(basePrimes != NULL);
+    for (long long int i = 3; i <= root; i += 2) {
+        if (!small[i]) {
+            basePrimes[basePrimesSize++] = i;
+            for (long long int j = i * i; j <= root; j += 2 * i) {
+                small[j] = 1;
+            }
+        }
+    }
+    free(small);
+
+    //sieve the odd numbers up to n one segment at a time
+    segment = malloc(SIEVE_SEGMENT_SIZE * sizeof(unsigned char));
+    assert(segment != NULL);
+    for (long long int low = 3; low <= n; low += 2 * SIEVE_SEGMENT_SIZE) {
+        //The last number of the segment.
+        long long int high = low + 2 * (SIEVE_SEGMENT_SIZE - 1);
+        if (high > n) {
+            high = n;
+        }
+        //The number of odd numbers in the segment.
+        long long int segmentSize = (high - low) / 2 + 1;
+
+        for (long long int i = 0; i < segmentSize; ++i) {
+            segment[i] = 1;
+        }
+
+        //updates all odd multiples of the base primes as non-prime
+        for (long long int i = 0; i < basePrimesSize && basePrimes[i] * basePrimes[i] <= high; ++i) {
+            //The first odd multiple to cross out.
+            long long int start = basePrimes[i] * basePrimes[i];
+            if (start < low) {
+                start = (low + basePrimes[i] - 1) / basePrimes[i] * basePrimes[i];
+                if (start % 2 == 0) {
+                    start += basePrimes[i];
+                }
+            }
+            for (long long int j = (start - low) / 2; j < segmentSize; j += basePrimes[i]) {
+                segment[j] = 0;
+            }
+        }
+
+        for (long long int i = 0; i < segmentSize; ++i) {
+            if (segment[i]) {
+                appendPrime(list, &gapsCapacity, &checkpointCapacity, previous, low + 2 * i);
+                previous = low + 2 * i;
+            }
+        }
+    }
+
+    free(segment);
+    free(basePrimes);
+    list->gaps = realloc(list->gaps, (list->gapsSize > 0 ? list->gapsSize : 1) * sizeof(unsigned char));
+    assert(list->gaps != NULL);
+    return list;
+}
+
+/**
+ * Searches for the index-th prime number of a gap-encoded list.
+ * @details jumps to the nearest checkpoint and decodes at most checkpointInterval gaps.
+ * @warning index must be lower than the list size.
+ *
+ * @param list the gap-encoded list.
+ * @param index the position of the prime number, starting from 0.
+ * @return the index-th prime number of the list.
+ */
+long long int compressedPrimeAt(compressedPrimeList *list, long long int index) {
+    assert(index >= 0 && index < list->size);
+
+    //The checkpoint preceding the prime number.
+    long long int checkpoint = index / list->checkpointInterval;
+    //The prime number.
+    long long int res = list->checkpointValue[checkpoint];
+    //The position in gaps of the next gap.
+    long long int offset = list->checkpointOffset[checkpoint];
+
+    for (long long int i = checkpoint * list->checkpointInterval; i < index; ++i) {
+        res += readGap(list->gaps, &offset);
+    }
+
+    return res;
+}
+
+/**
+ * Saves a gap-encoded list of prime numbers to a file.
+ *
+ * @param list the gap-encoded list.
+ * @param fileName the name of the file.
+ */
+void saveCompressedPrimeList(compressedPrimeList *list, const char *fileName) {
+    //The file.
+    FILE *file = fopen(fileName, "wb");
+    assert(file != NULL && "the file cannot be opened");
+
+    fwrite(&list->size, sizeof(long long int), 1, file);
+    fwrite(&list->checkpointInterval, sizeof(long long int), 1, file);
+    fwrite(&list->checkpointSize, sizeof(long long int), 1, file);
+    fwrite(&list->gapsSize, sizeof(long long int), 1, file);
+    fwrite(list->checkpointValue, sizeof(long long int), list->checkpointSize, file);
+    fwrite(list->checkpointOffset, sizeof(long long int), list->checkpointSize, file);
+    fwrite(list->gaps, sizeof(unsigned char), list->gapsSize, file);
+
+    fclose(file);
+}
+
+/**
+ * Loads a gap-encoded list of prime numbers from a file.
+ * @warning the file must have been written by saveCompressedPrimeList.
+ *
+ * @param fileName the name of the file.
+ * @return the gap-encoded list.
+ */
+compressedPrimeList *loadCompressedPrimeList(const char *fileName) {
+    //The file.
+    FILE *file = fopen(fileName, "rb");
+    assert(file != NULL && "the file cannot be opened");
+    //The gap-encoded list.
+    compressedPrimeList *list = malloc(sizeof(compressedPrimeList));
+    assert(list != NULL);
+    //The number of elements read.
+    size_t read = 0;
+
+    read += fread(&list->size, sizeof(long long int), 1, file);
+    read += fread(&list->checkpointInterval, sizeof(long long int), 1, file);
+    read += fread(&list->checkpointSize, sizeof(long long int), 1, file);
+    read += fread(&list->gapsSize, sizeof(long long int), 1, file);
+    assert(read == 4 && "the file is not a compressed prime list");
+
+    list->checkpointValue = malloc((list->checkpointSize > 0 ? list->checkpointSize : 1) * sizeof(long long int));
+    assert(list->checkpointValue != NULL);
+    list->checkpointOffset = malloc((list->checkpointSize > 0 ? list->checkpointSize : 1) * sizeof(long long int));
+    assert(list->checkpointOffset != NULL);
+    list->gaps = malloc((list->gapsSize > 0 ? list->gapsSize : 1) * sizeof(unsigned char));
+    assert(list->gaps != NULL);
+
+    read = fread(list->checkpointValue, sizeof(long long int), list->checkpointSize, file);
+    read += fread(list->checkpointOffset, sizeof(long long int), list->checkpointSize, file);
+    read += fread(list->gaps, sizeof(unsigned char), list->gapsSize, file);
+    assert(read == (size_t) (2 * list->checkpointSize + list->gapsSize) && "the file is truncated");
+
+    fclose(file);
+    return list;
+}
+
+/**
+ * Deletes a gap-encoded list of prime numbers.
+ *
+ * @param list the gap-encoded list to be deleted.
+ */
+void deleteCompressedPrimeList(compressedPrimeList *list) {
+    free(list->gaps);
+    free(list->checkpointValue);
+    free(list->checkpointOffset);
+    free(list);
+}
+
+/**
+ * Creates a streaming decoder over a gap-encoded list of prime numbers.
+ * @warning index must be lower than or equal to the list size.
+ *
+ * @param list the gap-encoded list.
+ * @param index the index of the first prime to decode.
+ * @return the decoder.
+ */
+compressedPrimeDecoder *createCompressedPrimeDecoder(compressedPrimeList *list, long long int index) {
+    assert(index >= 0 && index <= list->size);
+
+    //The decoder.
+    compressedPrimeDecoder *decoder = malloc(sizeof(compressedPrimeDecoder));
+    assert(decoder != NULL);
+
+    decoder->list = list;
+    decoder->index = index;
+    decoder->offset = 0;
+    decoder->value = 0;
+
+    if (index == list->size) {
+        return decoder;
+    }
+
+    //start from the checkpoint preceding the prime number and move forward to it
+    decoder->offset = list->checkpointOffset[index / list->checkpointInterval];
+    decoder->value = list->checkpointValue[index / list->checkpointInterval];
+    for (long long int i = (index / list->checkpointInterval) * list->checkpointInterval; i < index; ++i) {
+        decoder->value += readGap(list->gaps, &decoder->offset);
+    }
+
+    return decoder;
+}
+
+/**
+ * Decodes the next prime numbers of a gap-encoded list.
+ * @details the gaps of the block are first unpacked, then prefix-summed into the buffer.
+ *
+ * @param decoder the decoder.
+ * @param buffer the list where the prime numbers are written.
+ * @param bufferSize the maximum number of prime numbers to decode.
+ * @return the number of prime numbers decoded, 0 when the list is over.
+ */
+long long int decodeCompressedPrimes(compressedPrimeDecoder *decoder, long long int *buffer, long long int bufferSize) {
+    //The number of prime numbers decoded.
+    long long int res = 0;
+    //The gaps of the current block, the first one is 0 because the block starts from the pending prime.
+    long long int gap[DECODER_BLOCK_SIZE];
+
+    while (res < bufferSize && decoder->index < decoder->list->size) {
+        //The number of prime numbers of the current block.
+        long long int blockSize = decoder->list->size - decoder->index;
+        if (blockSize > bufferSize - res) {
+            blockSize = bufferSize - res;
+        }
+        if (blockSize > DECODER_BLOCK_SIZE) {
+            blockSize = DECODER_BLOCK_SIZE;
+        }
+        //The position in the block.
+        long long int i = 0;
+
+        //unpack the varbytes
+        gap[0] = 0;
+        for (i = 1; i < blockSize; ++i) {
+            gap[i] = readGap(decoder->list->gaps, &decoder->offset);
+        }
+
+        //prefix-sum the gaps four at a time, so that the dependency chain is only on the last lane
+        for (i = 0; i + 4 <= blockSize; i += 4) {
+            //The partial sums of the four gaps.
+            long long int s0 = gap[i];
+            long long int s1 = s0 + gap[i + 1];
+            long long int s2 = s1 + gap[i + 2];
+            long long int s3 = s2 + gap[i + 3];
+
+            buffer[res + i] = decoder->value + s0;
+            buffer[res + i + 1] = decoder->value + s1;
+            buffer[res + i + 2] = decoder->value + s2;
+            buffer[res + i + 3] = decoder->value + s3;
+            decoder->value += s3;
+        }
+        for (; i < blockSize; ++i) {
+            decoder->value += gap[i];
+            buffer[res + i] = decoder->value;
+        }
+
+        res += blockSize;
+        decoder->index += blockSize;
+
+        //the next pending prime
+        if (decoder->index < decoder->list->size) {
+            decoder->value += readGap(decoder->list->gaps, &decoder->offset);
+        }
+    }
+
+    return res;
+}
+
+/**
+ * Deletes a streaming decoder.
+ *
+ * @param decoder the decoder to be deleted.
+ */
+void deleteCompressedPrimeDecoder(compressedPrimeDecoder *decoder) {
+    free(decoder);
+}
@@ -1,15 +1,148 @@
 #include <assert.h>
+#include <stdlib.h>
 
 #include "../ModularArithmetic.h"
 
 
+/**
+ * Merges two modular linear equations into one.
+ * @details x = a1 (mod m1) and x = a2 (mod m2) become x = a1 + m1 * t (mod lcm(m1, m2)),
+ * @details t = (a2 - a1)/g * (m1/g)^-1 (mod m2/g) with g = gcd(m1, m2), every product is computed on 128 bits.
+ * @warning a1 and a2 must be reduced modulo m1 and m2.
+ *
+ * @param a1 the first parameter.
+ * @param m1 the first module value.
+ * @param a2 the second parameter.
+ * @param m2 the second module value.
+ * @param x the merged parameter.
+ * @param lcm the merged module value.
+ * @return 1 if the equations have a common solution, 0 if they are inconsistent, -1 if lcm(m1, m2) is not lower than 2^63.
+ */
+static long long int mergeCongruences(long long int a1, long long int m1, long long int a2, long long int m2,
+                                      long long int *x, long long int *lcm) {
+    //The first number of Bézout's identity - the inverse of m1/g modulo m2/g.
+    long long int inverse = 0;
+    //The second number of Bézout's identity.
+    long long int y = 0;
+    //The gcd between m1 and m2.
+    long long int g = extendedGCD(m1, m2, &inverse, &y);
+    //The difference a2 - a1, it fits in 64 bits since both are reduced.
+    long long int delta = a2 - a1;
+    //The merged module value.
+    unsigned __int128 merged = (unsigned __int128) (m1 / g) * (unsigned long long int) m2;
+    //The step t, modulo m2/g.
+    long long int t = 0;
+
+    if (delta % g != 0) {
+        return 0;
+    }
+    if (merged >= (unsigned __int128) 1 << 63) {
+        return -1;
+    }
+
+    m2 /= g;
+    delta = (delta / g) % m2;
+    //m1 * inverse + m2 * y == g: inverse is the inverse of m1/g modulo m2/g
+    t = product(delta < 0 ? delta + m2 : delta, inverse < 0 ? inverse % m2 + m2 : inverse % m2, m2);
+
+    *lcm = (long long int) merged;
+    *x = (long long int) (((unsigned __int128) m1 * (unsigned long long int) t + (unsigned long long int) a1) % merged);
+    return 1;
+}
+
+/**
+ * Merges a range of modular linear equations into one.
+ * @details divide-and-conquer: the two halves are merged recursively, then into each other.
+ *
+ * @param a the parameters, reduced.
+ * @param m the module values.
+ * @param from the first equation of the range.
+ * @param to the last equation of the range, excluded.
+ * @param x the merged parameter.
+ * @param lcm the merged module value.
+ * @return 1 if the equations have a common solution, 0 if they are inconsistent, -1 if the lcm is not lower than 2^63.
+ */
+static long long int mergeRange(long long int *a, long long int *m, long long int from, long long int to,
+                                long long int *x, long long int *lcm) {
+    //The middle of the range.
+    long long int middle = from + (to - from) / 2;
+    //The merged parameter of the right half.
+    long long int xRight = 0;
+    //The merged module value of the right half.
+    long long int lcmRight = 1;
+    //The result of the left half.
+    long long int left = 0;
+    //The result of the right half.
+    long long int right = 0;
+
+    if (to - from == 1) {
+        *x = a[from];
+        *lcm = m[from];
+        return 1;
+    }
+
+    left = mergeRange(a, m, from, middle, x, lcm);
+    right = mergeRange(a, m, middle, to, &xRight, &lcmRight);
+    //an inconsistent half makes the system inconsistent, even if the other one overflows
+    if (left == 0 || right == 0) {
+        return 0;
+    }
+    if (left < 0 || right < 0) {
+        return -1;
+    }
+
+    return mergeCongruences(*x, *lcm, xRight, lcmRight, x, lcm);
+}
+
+
+/**
+ * Combines two rows (or columns) of a matrix modulo m with a unimodular transformation.
+ * @details with g = gcd(x, y) = s * x + t * y: u = s * u + t * v and v = -(y/g) * u + (x/g) * v,
+ * @details the determinant is (s * x + t * y) / g = 1, so the transformation is invertible modulo m and v gets 0 where y was.
+ * @details the pivot value x never grows, and it is left as it is if it divides y, so the elimination terminates.
+ *
+ * @param u the first row, x at the pivot.
+ * @param v the second row, y at the pivot.
+ * @param length the length of the rows.
+ * @param stride the distance between two elements of a row, the number of columns to combine columns.
+ * @param x the pivot value of the first row.
+ * @param y the pivot value of the second row.
+ * @param m the module value.
+ */
+static void combineLines(long long int *u, long long int *v, long long int length, long long int stride,
+                         long long int x, long long int y, long long int m) {
+    //The first number of Bézout's identity.
+    long long int s = 0;
+    //The second number of Bézout's identity.
+    long long int t = 0;
+    //The gcd between x and y.
+    long long int g = x;
+
+    //y multiple of x: v = v - (y/x) * u leaves u as it is, otherwise the pivot gets smaller
+    if (x != 0 && y % x == 0) {
+        s = 1;
+    } else {
+        g = extendedGCD(x, y, &s, &t);
+    }
+
+    for (long long int k = 0; k < length * stride; k += stride) {
+        //The element of the first row.
+        long long int uk = u[k];
+
+        u[k] = sum(product(s, uk, m), product(t, v[k], m), m);
+        v[k] = sub(product(x / g, v[k], m), product(y / g, uk, m), m);
+    }
+}
+
+
 /**
  * Computes the solution of a system of modular linear equations.
  * @details Chinese Reminder Theorem.
  * @example x = a1 (mod m1)
  * @example ...
  * @example x = ai (mod mi)
- * @warning all mi value must be coprime.
+ * @details Garner's algorithm, see createCrtContext; use a precomputation to solve many systems with the same module values.
+ * @warning all mi value must be coprime, their product must be lower than 2^63.
  *
  * @param numberOfEquation the number of equations of the linear system.
  * @param a the parameters.
@@ -17,36 +150,270 @@
  * @return the solution of the system of modular linear equations.
  */
 long long int chineseReminderTheorem(long long int numberOfEquation, long long int *a, long long int *m) {
-    //check if all modulo values are coprime
+    //The Garner precomputation.
+    crtContext *context = createCrtContext(numberOfEquation, m);
+    assert(context != NULL && "all module value must be coprime");
+    //The result.
+    long long int res = crtReconstruct(context, a);
+
+    deleteCrtContext(context);
+    return res;
+}
+
+/**
+ * Creates the Garner precomputation of the Chinese Reminder Theorem.
+ * @details O(k^2) products modulo the module values, then every reconstruction takes O(k^2) products and no inverse.
+ * @details the module values are pairwise coprime iff every m_0 * ... * m_(i-1) is invertible modulo m_i.
+ *
+ * @param numberOfEquation the number of module values.
+ * @param m the module values, they are copied.
+ * @return the precomputation, NULL if the module values are not pairwise coprime.
+ */
+crtContext *createCrtContext(long long int numberOfEquation, long long int *m) {
+    assert(numberOfEquation >= 0);
+
+    //The precomputation.
+    crtContext *context = malloc(sizeof(crtContext));
+    assert(context != NULL);
+    //The product of the module values, as long as it fits in 128 bits.
+    unsigned __int128 modulus = 1;
+
+    context->size = numberOfEquation;
+    context->m = malloc((numberOfEquation > 0 ? numberOfEquation : 1) * sizeof(long long int));
+    context->radix = malloc((numberOfEquation > 1 ? numberOfEquation * (numberOfEquation - 1) / 2 : 1) * sizeof(long long int));
+    context->inverse = malloc((numberOfEquation > 0 ? numberOfEquation : 1) * sizeof(long long int));
+    assert(context->m != NULL && context->radix != NULL && context->inverse != NULL);
+    context->words = 0;
+
     for (long long int i = 0; i < numberOfEquation; ++i) {
-        for (long long int j = 0; j < numberOfEquation; ++j) {
-            if (i != j) {
-                assert(areCoPrime(m[i], m[j]) && "all module value must be coprime");
-            }
+        assert(m[i] > 0);
+
+        //The mixed-radix constants of the row i.
+        long long int *radix = context->radix + i * (i - 1) / 2;
+        //The product m_0 * ... * m_(i-1) (mod m_i).
+        long long int prefix = 1 % m[i];
+        //The first number of Bézout's identity.
+        long long int x = 0;
+        //The second number of Bézout's identity.
+        long long int y = 0;
+
+        context->m[i] = m[i];
+        for (long long int j = 0; j < i; ++j) {
+            radix[j] = prefix;
+            prefix = product(prefix, m[j], m[i]);
+        }
+        //m_i shares a factor with some m_j, j < i
+        if (extendedGCD(prefix, m[i], &x, &y) != 1) {
+            deleteCrtContext(context);
+            return NULL;
+        }
+        context->inverse[i] = x < 0 ? x + m[i] : x % m[i];
+
+        //the bits of the product, m_0 * ... * m_i < 2^(bits(m_0) + ... + bits(m_i))
+        context->words += 64 - __builtin_clzll((unsigned long long int) m[i]);
+        if (modulus != 0) {
+            modulus = modulus > ~(unsigned __int128) 0 / (unsigned long long int) m[i] ? 0 : modulus * (unsigned long long int) m[i];
         }
     }
 
-    //The final modulo value.
-    long long int M = 1;
-    //M / mi.
-    long long int mi = 0;
-    //mi inverse.
-    long long int miInverse = 0;
+    context->words = context->words > 0 ? (context->words + 63) / 64 : 1;
+    context->modulus = modulus != 0 && modulus < ((unsigned __int128) 1 << 63) ? (long long int) modulus : 0;
+    return context;
+}
+
+/**
+ * Computes the mixed-radix digits of the solution of a system of modular linear equations.
+ * @details Garner's algorithm: x = v_0 + v_1 * m_0 + ... + v_(k-1) * m_0 * ... * m_(k-2) with 0 <= v_i < m_i.
+ *
+ * @param context the Garner precomputation.
+ * @param a the parameters, a_i modulo m_i.
+ * @param digits the mixed-radix digits, k values.
+ */
+void crtMixedRadix(crtContext *context, long long int *a, long long int *digits) {
+    for (long long int i = 0; i < context->size; ++i) {
+        //The module value.
+        long long int m = context->m[i];
+        //The mixed-radix constants of the row i.
+        long long int *radix = context->radix + i * (i - 1) / 2;
+        //The digits found so far, modulo m_i.
+        unsigned long long int partial = 0;
+        //The parameter, reduced modulo m_i.
+        long long int ai = a[i] < 0 ? modularReduction(mod(a[i], m), m) : mod(a[i], m);
+
+        //digits and constants are reduced: one 128-bit reduction per term
+        for (long long int j = 0; j < i; ++j) {
+            partial = (unsigned long long int) (((unsigned __int128) digits[j] * (unsigned long long int) radix[j] + partial) % (unsigned long long int) m);
+        }
+        digits[i] = product(ai - (long long int) partial + (ai < (long long int) partial ? m : 0), context->inverse[i], m);
+    }
+}
+
+/**
+ * Computes the solution of a system of modular linear equations using the Garner precomputation.
+ * @warning the product of the module values must be lower than 2^63.
+ *
+ * @param context the Garner precomputation.
+ * @param a the parameters, a_i modulo m_i.
+ * @return the solution modulo the product of the module values.
+ */
+long long int crtReconstruct(crtContext *context, long long int *a) {
+    assert((context->modulus != 0 || context->size == 0) && "the product of the module values must be lower than 2^63");
+
+    //The mixed-radix digits.
+    long long int *digits = malloc((context->size > 0 ? context->size : 1) * sizeof(long long int));
+    assert(digits != NULL);
     //The result.
     long long int res = 0;
 
-    //compute the final modulo value
-    for (long long int i = 0; i < numberOfEquation; ++i) {
-        M *= m[i];
+    crtMixedRadix(context, a, digits);
+    //Horner's rule: res = v_(i) + res * m_(i), it never exceeds the product
+    for (long long int i = context->size - 1; i >= 0; --i) {
+        res = res * context->m[i] + digits[i];
+    }
+
+    free(digits);
+    return res;
+}
+
+/**
+ * Computes the solution of a system of modular linear equations on 128 bits using the Garner precomputation.
+ * @warning the product of the module values must be lower than 2^128.
+ *
+ * @param context the Garner precomputation.
+ * @param a the parameters, a_i modulo m_i.
+ * @return the solution modulo the product of the module values.
+ */
+unsigned __int128 crtReconstruct128(crtContext *context, long long int *a) {
+    //The solution on words.
+    unsigned long long int *words = malloc(context->words * sizeof(unsigned long long int));
+    assert(words != NULL);
+    //The result.
+    unsigned __int128 res = 0;
+
+    crtReconstructWords(context, a, words);
+    for (long long int i = 2; i < context->words; ++i) {
+        assert(words[i] == 0 && "the product of the module values must be lower than 2^128");
+    }
+    res = words[0];
+    if (context->words > 1) {
+        res |= (unsigned __int128) words[1] << 64;
     }
 
-    //compute the mi values.
+    free(words);
+    return res;
+}
+
+/**
+ * Computes the solution of a system of modular linear equations on many words using the Garner precomputation.
+ * @details the mixed-radix digits are combined by Horner's rule, one multiplication by a word per module value.
+ *
+ * @param context the Garner precomputation.
+ * @param a the parameters, a_i modulo m_i.
+ * @param res the solution modulo the product of the module values, context->words 64-bit words, least significant first.
+ */
+void crtReconstructWords(crtContext *context, long long int *a, unsigned long long int *res) {
+    //The mixed-radix digits.
+    long long int *digits = malloc((context->size > 0 ? context->size : 1) * sizeof(long long int));
+    assert(digits != NULL);
+
+    crtMixedRadix(context, a, digits);
+    for (long long int i = 0; i < context->words; ++i) {
+        res[i] = 0;
+    }
+
+    //Horner's rule: res = v_(i) + res * m_(i), the carry ripples through the words
+    for (long long int i = context->size - 1; i >= 0; --i) {
+        //The carry, it starts with the digit.
+        unsigned __int128 carry = (unsigned long long int) digits[i];
+
+        for (long long int j = 0; j < context->words; ++j) {
+            carry += (unsigned __int128) res[j] * (unsigned long long int) context->m[i];
+            res[j] = (unsigned long long int) carry;
+            carry >>= 64;
+        }
+    }
+
+    free(digits);
+}
+
+/**
+ * Computes the solution of many systems of modular linear equations using the Garner precomputation.
+ * @warning the product of the module values must be lower than 2^63.
+ *
+ * @param context the Garner precomputation.
+ * @param numberOfValues the number of systems.
+ * @param a the parameters, numberOfValues rows of k values.
+ * @param res the solution of every system.
+ */
+void crtReconstructBatch(crtContext *context, long long int numberOfValues, long long int *a, long long int *res) {
+    assert((context->modulus != 0 || context->size == 0) && "the product of the module values must be lower than 2^63");
+
+    //The mixed-radix digits, shared by the systems.
+    long long int *digits = malloc((context->size > 0 ? context->size : 1) * sizeof(long long int));
+    assert(digits != NULL);
+
+    for (long long int i = 0; i < numberOfValues; ++i) {
+        crtMixedRadix(context, a + i * context->size, digits);
+        res[i] = 0;
+        for (long long int j = context->size - 1; j >= 0; --j) {
+            res[i] = res[i] * context->m[j] + digits[j];
+        }
+    }
+
+    free(digits);
+}
+
+/**
+ * Deletes the Garner precomputation of the Chinese Reminder Theorem.
+ *
+ * @param context the precomputation to be deleted.
+ */
+void deleteCrtContext(crtContext *context) {
+    free(context->m);
+    free(context->radix);
+    free(context->inverse);
+    free(context);
+}
+
+/**
+ * Computes the solution of a system of modular linear equations whose module values may share factors.
+ * @details generalized Chinese Reminder Theorem: two equations x = a1 (mod m1), x = a2 (mod m2) have a solution iff
+ * @details g = gcd(m1, m2) divides a2 - a1, then x = a1 + m1 * t (mod lcm(m1, m2)) with t = (a2 - a1)/g * (m1/g)^-1 (mod m2/g).
+ * @details the equations are merged on a divide-and-conquer tree, so the operands stay balanced.
+ * @example x = a1 (mod m1)
+ * @example ...
+ * @example x = ai (mod mi)
+ *
+ * @param numberOfEquation the number of equations of the linear system.
+ * @param a the parameters.
+ * @param m the module values, positive.
+ * @param x the solution modulo the lcm of the module values.
+ * @param lcm the lcm of the module values.
+ * @return 1 if the system has a solution, 0 if it is inconsistent, -1 if the lcm of the module values is not lower than 2^63.
+ */
+long long int generalizedChineseReminderTheorem(long long int numberOfEquation, long long int *a, long long int *m,
+                                                long long int *x, long long int *lcm) {
+    //The reduced parameters.
+    long long int *reduced = NULL;
+    //The result.
+    long long int res = 1;
+
+    *x = 0;
+    *lcm = 1;
+    if (numberOfEquation == 0) {
+        return 1;
+    }
+
+    reduced = malloc(numberOfEquation * sizeof(long long int));
+    assert(reduced != NULL);
     for (long long int i = 0; i < numberOfEquation; ++i) {
-        mi = M / m[i];
-        miInverse = modularInverse(mi, m[i]);
-        res = (res + a[i] * mi * miInverse) % M;
+        assert(m[i] > 0);
+        reduced[i] = a[i] < 0 ? modularReduction(mod(a[i], m[i]), m[i]) : mod(a[i], m[i]);
     }
 
+    res = mergeRange(reduced, m, 0, numberOfEquation, x, lcm);
+
+    free(reduced);
     return res;
 }
 
@@ -76,4 +443,164 @@ void diophantineEquation(long long int a, long long int *x, long long int b, lon
 
     *x *= c;
     *y *= c;
-}
\ No newline at end of file
+}
+
+/**
+ * Computes the solutions of a linear congruence.
+ * @details a * x == b (mod m) has a solution iff g = gcd(a, m) divides b, then the g solutions are
+ * @details x = base + k * step (mod m) for 0 <= k < g, with step = m / g and base = (b/g) * (a/g)^-1 (mod m/g).
+ *
+ * @param a the coefficient.
+ * @param b the known term.
+ * @param m the module value.
+ * @param base the smallest solution.
+ * @param step the distance between two consecutive solutions, m / gcd(a, m).
+ * @return the number of solutions modulo m, gcd(a, m), 0 if there is no solution.
+ */
+long long int linearCongruence(long long int a, long long int b, long long int m, long long int *base, long long int *step) {
+    assert(m > 0);
+
+    //The first number of Bézout's identity - the inverse of a/g modulo m/g.
+    long long int x = 0;
+    //The second number of Bézout's identity.
+    long long int y = 0;
+    //The gcd between a and m.
+    long long int g = 0;
+
+    a = a < 0 ? modularReduction(mod(a, m), m) : mod(a, m);
+    b = b < 0 ? modularReduction(mod(b, m), m) : mod(b, m);
+    g = extendedGCD(a, m, &x, &y);
+    if (b % g != 0) {
+        return 0;
+    }
+
+    *step = m / g;
+    *base = product(b / g, x, *step);
+    return g;
+}
+
+/**
+ * Computes a solution of a system of linear congruences.
+ * @details A * x == b (mod m) with m composite: the Smith normal form D = U * A * V (mod m) is diagonal,
+ * @details U and V are products of unimodular combinations of rows and columns, see combineLines.
+ * @details then D * y == U * b is made of linear congruences d_i * y_i == c_i and x = V * y.
+ * @details there are prod(gcd(d_i, m)) solutions, m for every column without pivot.
+ * @details the elimination is exact on 64-bit integers, only the matrices hold doubles.
+ * @warning m must be at most 2^53, the residues are read from and written to double matrices.
+ *
+ * @param a the coefficients - M: k x n.
+ * @param b the known terms - M: k x 1.
+ * @param x a solution - M: n x 1.
+ * @param m the module value.
+ * @return the number of solutions modulo m, 0 if there is no solution, -1 if they are not less than 2^63.
+ */
+long long int linearSystemModulo(matrix *a, matrix *b, matrix *x, long long int m) {
+    assert(m > 0 && m <= (1LL << 53) && "the residues must be exact in a double");
+    assert(b->n == a->n && b->m == 1);
+    assert(x->n == a->m && x->m == 1);
+
+    //The number of equations.
+    long long int rows = a->n;
+    //The number of unknowns.
+    long long int columns = a->m;
+    //The number of pivots.
+    long long int pivots = rows < columns ? rows : columns;
+    //The coefficients, then D - row major.
+    long long int *d = malloc(rows * columns * sizeof(long long int));
+    //The known terms, then U * b.
+    long long int *c = malloc(rows * sizeof(long long int));
+    //The column transformation V - row major.
+    long long int *v = calloc(columns * columns, sizeof(long long int));
+    //The solution of D * y == U * b.
+    long long int *y = malloc(columns * sizeof(long long int));
+    assert(d != NULL && c != NULL && v != NULL && y != NULL);
+    //The number of solutions.
+    unsigned __int128 res = 1;
+
+    for (long long int i = 0; i < rows; ++i) {
+        for (long long int j = 0; j < columns; ++j) {
+            d[i * columns + j] = (long long int) a->matrix[i][j];
+            d[i * columns + j] = d[i * columns + j] < 0 ? modularReduction(mod(d[i * columns + j], m), m) : mod(d[i * columns + j], m);
+        }
+        c[i] = (long long int) b->matrix[i][0];
+        c[i] = c[i] < 0 ? modularReduction(mod(c[i], m), m) : mod(c[i], m);
+    }
+    for (long long int j = 0; j < columns; ++j) {
+        v[j * columns + j] = 1 % m;
+    }
+
+    for (long long int t = 0; t < pivots; ++t) {
+        //1 if the column t has elements below the pivot.
+        long long int dirty = 1;
+
+        while (dirty) {
+            //clear the column t below the pivot, on D and U * b
+            for (long long int i = t + 1; i < rows; ++i) {
+                if (d[i * columns + t] != 0) {
+                    //The pivot value.
+                    long long int pivot = d[t * columns + t];
+                    //The value to clear.
+                    long long int value = d[i * columns + t];
+
+                    combineLines(d + t * columns, d + i * columns, columns, 1, pivot, value, m);
+                    combineLines(c + t, c + i, 1, 1, pivot, value, m);
+                }
+            }
+            //clear the row t right of the pivot, on D and V
+            for (long long int j = t + 1; j < columns; ++j) {
+                if (d[t * columns + j] != 0) {
+                    //The pivot value.
+                    long long int pivot = d[t * columns + t];
+                    //The value to clear.
+                    long long int value = d[t * columns + j];
+
+                    combineLines(d + t, d + j, rows, columns, pivot, value, m);
+                    combineLines(v + t, v + j, columns, columns, pivot, value, m);
+                }
+            }
+            //the column operations may have filled the column t again
+            dirty = 0;
+            for (long long int i = t + 1; i < rows; ++i) {
+                dirty |= d[i * columns + t] != 0;
+            }
+        }
+    }
+
+    //d_i * y_i == c_i (mod m), 0 * y_i == c_i for the rows without pivot
+    for (long long int i = 0; i < columns && res != 0; ++i) {
+        //The distance between two solutions.
+        long long int step = 0;
+        //The number of solutions of the congruence.
+        long long int count = i < pivots ? linearCongruence(d[i * columns + i], c[i], m, &y[i], &step) : m;
+
+        if (i >= pivots) {
+            y[i] = 0;
+        }
+        res = res * (unsigned long long int) count;
+        if (res > ((unsigned __int128) 1 << 64)) {
+            res = (unsigned __int128) 1 << 64;
+        }
+    }
+    for (long long int i = pivots; i < rows && res != 0; ++i) {
+        if (c[i] != 0) {
+            res = 0;
+        }
+    }
+
+    //x = V * y
+    for (long long int i = 0; i < columns; ++i) {
+        //The element of the solution.
+        long long int xi = 0;
+
+        for (long long int j = 0; j < columns && res != 0; ++j) {
+            xi = sum(xi, product(v[i * columns + j], y[j], m), m);
+        }
+        x->matrix[i][0] = (double) xi;
+    }
+
+    free(d);
+    free(c);
+    free(v);
+    free(y);
+    return res >= ((unsigned __int128) 1 << 63) ? -1 : (long long int) res;
+}
@@ -0,0 +1,626 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * The largest prime factor of p - 1 left to Pohlig-Hellman instead of linear algebra.
+ */
+#define INDEX_CALCULUS_SUBGROUP_LIMIT (1LL << 24)
+
+/**
+ * The number of relations collected beyond the size of the factor base.
+ */
+#define INDEX_CALCULUS_EXTRA_RELATIONS 32
+
+/**
+ * The number of random exponents tried to smooth a number before giving up.
+ */
+#define INDEX_CALCULUS_SMOOTHING_LIMIT 100000000LL
+
+/**
+ * The largest number of prime factors, with multiplicity, of a number below 2^63.
+ */
+#define MAX_FACTORS 64
+
+
+/**
+ * Struct --> represents a sparse row of a linear system modulo n.
+ *
+ * @details size - the number of non-zero coefficients.
+ * @details column - the columns of the non-zero coefficients, sorted.
+ * @details value - the non-zero coefficients.
+ * @details rhs - the right-hand side.
+ */
+typedef struct SparseRow {
+    long long int size;
+    long long int *column;
+    long long int *value;
+    long long int rhs;
+}sparseRow;
+
+/**
+ * Struct --> represents the state shared by the threads collecting relations.
+ *
+ * @details context - the index-calculus precomputation.
+ * @details relation - the relations collected: the exponents of the factor base and the exponent of base as rhs.
+ * @details target - the number of relations to collect.
+ * @details size - the number of relations collected.
+ * @details done - 1 when the target is reached, read without the lock.
+ * @details lock - the mutex protecting relation and size.
+ */
+typedef struct RelationCollector {
+    indexCalculus *context;
+    sparseRow *relation;
+    long long int target;
+    long long int size;
+    atomic_int done;
+    pthread_mutex_t lock;
+}relationCollector;
+
+/**
+ * Struct --> represents the argument of a thread collecting relations.
+ *
+ * @details collector - the state shared by the threads.
+ * @details seed - the seed of the pseudo-random generator of the thread.
+ */
+typedef struct RelationWorker {
+    relationCollector *collector;
+    unsigned long long int seed;
+}relationWorker;
+
+
+/**
+ * Factorizes a number over the factor base.
+ * @details trial division by every prime of the factor base.
+ *
+ * @param context the index-calculus precomputation.
+ * @param y the number.
+ * @param index the positions in the factor base of the prime factors.
+ * @param exponent the exponents of the prime factors.
+ * @param size the number of different prime factors.
+ * @return 1 if the number is smooth over the factor base, 0 otherwise.
+ */
+static int factorOverBase(indexCalculus *context, long long int y, long long int *index, long long int *exponent, long long int *size) {
+    *size = 0;
+
+    for (long long int i = 0; i < context->factorBaseSize && y > 1; ++i) {
+        if (y % context->factorBase[i] == 0) {
+            index[*size] = i;
+            exponent[*size] = 0;
+            while (y % context->factorBase[i] == 0) {
+                y /= context->factorBase[i];
+                exponent[*size]++;
+            }
+            (*size)++;
+        }
+    }
+
+    return y == 1;
+}
+
+/**
+ * Collects relations until the shared target is reached.
+ * @details the candidates are tested without the lock, it is taken only to append a smooth one.
+ *
+ * @param argument the argument of the thread - relationWorker.
+ * @return NULL.
+ */
+static void *collectRelations(void *argument) {
+    //The argument of the thread.
+    relationWorker *worker = argument;
+    //The state shared by the threads.
+    relationCollector *collector = worker->collector;
+    //The index-calculus precomputation.
+    indexCalculus *context = collector->context;
+    //The state of the pseudo-random generator.
+    unsigned long long int state = worker->seed;
+    //The positions in the factor base of the prime factors.
+    long long int index[MAX_FACTORS];
+    //The exponents of the prime factors.
+    long long int exponent[MAX_FACTORS];
+    //The number of different prime factors.
+    long long int size = 0;
+
+    while (!atomic_load_explicit(&collector->done, memory_order_relaxed)) {
+        //The random exponent.
+        long long int k = (long long int) (nextRandom(&state) % (unsigned long long int) context->order);
+
+        if (!factorOverBase(context, power(context->base, k, context->p), index, exponent, &size)) {
+            continue;
+        }
+
+        pthread_mutex_lock(&collector->lock);
+        if (collector->size < collector->target) {
+            //The new relation.
+            sparseRow *row = &collector->relation[collector->size++];
+
+            row->size = size;
+            row->column = malloc((size > 0 ? size : 1) * sizeof(long long int));
+            assert(row->column != NULL);
+            row->value = malloc((size > 0 ? size : 1) * sizeof(long long int));
+            assert(row->value != NULL);
+            memcpy(row->column, index, size * sizeof(long long int));
+            memcpy(row->value, exponent, size * sizeof(long long int));
+            row->rhs = k;
+        }
+        if (collector->size >= collector->target) {
+            atomic_store_explicit(&collector->done, 1, memory_order_relaxed);
+        }
+        pthread_mutex_unlock(&collector->lock);
+    }
+
+    return NULL;
+}
+
+/**
+ * Checks if a sparse row has a non-zero coefficient in a column.
+ * @details binary search.
+ *
+ * @param row the sparse row.
+ * @param column the column.
+ * @return the position of the coefficient in the row, -1 if it is zero.
+ */
+static long long int findColumn(sparseRow *row, long long int column) {
+    //The first position of the search.
+    long long int low = 0;
+    //The last position of the search.
+    long long int high = row->size - 1;
+
+    while (low <= high) {
+        //The middle position.
+        long long int middle = (low + high) / 2;
+
+        if (row->column[middle] == column) {
+            return middle;
+        }
+        if (row->column[middle] < column) {
+            low = middle + 1;
+        }
+        else {
+            high = middle - 1;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Subtracts a multiple of a sparse row from another one.
+ * @details row = row - factor * pivot (mod n), merging the sorted columns.
+ *
+ * @param row the sparse row, updated.
+ * @param pivot the sparse row to subtract.
+ * @param factor the multiple.
+ * @param n the module value.
+ */
+static void subtractRow(sparseRow *row, sparseRow *pivot, long long int factor, long long int n) {
+    //The columns of the result.
+    long long int *column = malloc((row->size + pivot->size) * sizeof(long long int));
+    assert(column != NULL);
+    //The coefficients of the result.
+    long long int *value = malloc((row->size + pivot->size) * sizeof(long long int));
+    assert(value != NULL);
+    //The number of coefficients of the result.
+    long long int size = 0;
+    //The position in row.
+    long long int i = 0;
+    //The position in pivot.
+    long long int j = 0;
+
+    while (i < row->size || j < pivot->size) {
+        //The current column.
+        long long int c = 0;
+        //The current coefficient.
+        long long int v = 0;
+
+        if (j == pivot->size || (i < row->size && row->column[i] < pivot->column[j])) {
+            c = row->column[i];
+            v = row->value[i++];
+        }
+        else if (i == row->size || pivot->column[j] < row->column[i]) {
+            c = pivot->column[j];
+            v = sub(0, product(factor, pivot->value[j++], n), n);
+        }
+        else {
+            c = row->column[i];
+            v = sub(row->value[i++], product(factor, pivot->value[j++], n), n);
+        }
+
+        if (v != 0) {
+            column[size] = c;
+            value[size++] = v;
+        }
+    }
+
+    row->rhs = sub(row->rhs, product(factor, pivot->rhs, n), n);
+    free(row->column);
+    free(row->value);
+    row->column = column;
+    row->value = value;
+    row->size = size;
+}
+
+/**
+ * Solves a sparse linear system modulo n.
+ * @details Gauss-Jordan elimination: the columns are taken from the sparsest one,
+ * @details and the pivot is the shortest row whose coefficient is invertible modulo n, to limit the fill-in.
+ * @details the columns without a pivot are left free and set to 0.
+ *
+ * @param row the sparse rows, reduced in place.
+ * @param rows the number of rows.
+ * @param columns the number of columns.
+ * @param n the module value.
+ * @param solution the value of every column, -1 for the free ones.
+ */
+static void solveSparseSystem(sparseRow *row, long long int rows, long long int columns, long long int n, long long int *solution) {
+    //The number of rows using every column.
+    long long int *weight = calloc(columns, sizeof(long long int));
+    assert(weight != NULL);
+    //The columns sorted by weight.
+    long long int *columnOrder = malloc(columns * sizeof(long long int));
+    assert(columnOrder != NULL);
+    //The pivot row of every column, -1 if free.
+    long long int *pivotRow = malloc(columns * sizeof(long long int));
+    assert(pivotRow != NULL);
+    //1 for the rows already used as pivot.
+    char *used = calloc(rows, sizeof(char));
+    assert(used != NULL);
+
+    for (long long int r = 0; r < rows; ++r) {
+        for (long long int i = 0; i < row[r].size; ++i) {
+            weight[row[r].column[i]]++;
+        }
+    }
+
+    //insertion sort: the factor base is small and already nearly sorted by weight
+    for (long long int c = 0; c < columns; ++c) {
+        //The position of the column in the order.
+        long long int i = c;
+
+        while (i > 0 && weight[columnOrder[i - 1]] > weight[c]) {
+            columnOrder[i] = columnOrder[i - 1];
+            i--;
+        }
+        columnOrder[i] = c;
+        pivotRow[c] = -1;
+    }
+
+    for (long long int k = 0; k < columns; ++k) {
+        //The current column.
+        long long int c = columnOrder[k];
+        //The best pivot row.
+        long long int best = -1;
+        //The position of the pivot coefficient in the best row.
+        long long int bestPosition = -1;
+        //The inverse of the pivot coefficient.
+        long long int inverse = 0;
+
+        for (long long int r = 0; r < rows; ++r) {
+            if (used[r] || (best != -1 && row[r].size >= row[best].size)) {
+                continue;
+            }
+            //The position of the coefficient in the row.
+            long long int position = findColumn(&row[r], c);
+            if (position != -1 && gcd(row[r].value[position], n) == 1) {
+                best = r;
+                bestPosition = position;
+            }
+        }
+
+        if (best == -1) {
+            continue;
+        }
+        used[best] = 1;
+        pivotRow[c] = best;
+
+        //normalize the pivot coefficient to 1
+        inverse = modularInverse(row[best].value[bestPosition], n);
+        for (long long int i = 0; i < row[best].size; ++i) {
+            row[best].value[i] = product(row[best].value[i], inverse, n);
+        }
+        row[best].rhs = product(row[best].rhs, inverse, n);
+
+        //remove the column from every other row
+        for (long long int r = 0; r < rows; ++r) {
+            //The position of the coefficient in the row.
+            long long int position = r == best ? -1 : findColumn(&row[r], c);
+
+            if (position != -1) {
+                subtractRow(&row[r], &row[best], row[r].value[position], n);
+            }
+        }
+    }
+
+    //every pivot row now reads x_c + (free columns) = rhs
+    for (long long int c = 0; c < columns; ++c) {
+        solution[c] = pivotRow[c] == -1 ? -1 : row[pivotRow[c]].rhs;
+    }
+
+    free(weight);
+    free(columnOrder);
+    free(pivotRow);
+    free(used);
+}
+
+
+/**
+ * Creates the index-calculus precomputation of a base modulo a prime.
+ * @details relation collection: base^k (mod p) for random k is kept when it factors over the factor base,
+ * @details so k == sum(e_i * log(p_i)) (mod p - 1); the threads share the random search.
+ * @details linear algebra: the relations are solved modulo every prime power of p - 1 above 2^24
+ * @details by sparse Gauss-Jordan elimination, every logarithm found is verified in its subgroup.
+ * @details the prime powers of p - 1 below 2^24 are left to Pohlig-Hellman at query time.
+ * @warning p must be a prime number and base a primitive root modulo p.
+ *
+ * @param base the logarithm base.
+ * @param p the prime module value.
+ * @param factorBaseSize the number of small primes in the factor base.
+ * @param numberOfThreads the number of threads collecting relations.
+ * @return the index-calculus precomputation.
+ */
+indexCalculus *createIndexCalculus(long long int base, long long int p, long long int factorBaseSize, int numberOfThreads) {
+    assert(p > 2);
+    assert(factorBaseSize > 0);
+    assert(numberOfThreads > 0);
+
+    //The index-calculus precomputation.
+    indexCalculus *context = malloc(sizeof(indexCalculus));
+    assert(context != NULL);
+    //The number of prime factors of the order.
+    long long int factorSize = 0;
+    //The prime factors of the order.
+    long long int *factor = NULL;
+    //The large prime powers of the order.
+    long long int *largeFactor = NULL;
+    //The number of large prime powers of the order.
+    long long int largeFactorSize = 0;
+    //The logarithms of the factor base modulo every large prime power.
+    long long int **partial = NULL;
+    //The upper bound of the sieve used for the factor base.
+    long long int sieveBound = 16;
+    //The number of primes found by the sieve.
+    long long int primeSize = 0;
+    //The primes found by the sieve.
+    long long int *primes = NULL;
+
+    context->base = base < 0 ? modularReduction(mod(base, p), p) : mod(base, p);
+    context->p = p;
+    context->order = p - 1;
+    context->largeModulus = 1;
+    context->relations = 0;
+
+    //split the order in the large part, solved by linear algebra, and the small part
+    factor = factorisation(context->order, &factorSize);
+    largeFactor = malloc((factorSize > 0 ? factorSize : 1) * sizeof(long long int));
+    assert(largeFactor != NULL);
+    for (long long int i = 0; i < factorSize; ++i) {
+        if (factor[i] > INDEX_CALCULUS_SUBGROUP_LIMIT) {
+            largeFactor[largeFactorSize] = 1;
+            while (context->order / largeFactor[largeFactorSize] % factor[i] == 0) {
+                largeFactor[largeFactorSize] *= factor[i];
+            }
+            context->largeModulus *= largeFactor[largeFactorSize++];
+        }
+    }
+    context->smallModulus = context->order / context->largeModulus;
+    free(factor);
+
+    //the factor base from the sieve, only the primes below p are useful
+    do {
+        free(primes);
+        sieveBound *= 2;
+        primes = primeNumberList(sieveBound, &primeSize);
+    } while (primeSize < factorBaseSize && sieveBound < p);
+    context->factorBaseSize = 0;
+    context->factorBase = malloc(factorBaseSize * sizeof(long long int));
+    assert(context->factorBase != NULL);
+    for (long long int i = 0; i < primeSize && context->factorBaseSize < factorBaseSize && primes[i] < p; ++i) {
+        context->factorBase[context->factorBaseSize++] = primes[i];
+    }
+    free(primes);
+    context->logarithm = malloc(context->factorBaseSize * sizeof(long long int));
+    assert(context->logarithm != NULL);
+
+    //p - 1 is smooth: every query is a Pohlig-Hellman one
+    if (largeFactorSize == 0) {
+        for (long long int i = 0; i < context->factorBaseSize; ++i) {
+            context->logarithm[i] = 0;
+        }
+        free(largeFactor);
+        return context;
+    }
+
+    //collect the relations with every thread
+    //The state shared by the threads.
+    relationCollector collector;
+    //The threads.
+    pthread_t *thread = malloc(numberOfThreads * sizeof(pthread_t));
+    assert(thread != NULL);
+    //The arguments of the threads.
+    relationWorker *worker = malloc(numberOfThreads * sizeof(relationWorker));
+    assert(worker != NULL);
+    //The state of the pseudo-random generator.
+    unsigned long long int state = (unsigned long long int) p * 31 + (unsigned long long int) base;
+
+    collector.context = context;
+    collector.target = context->factorBaseSize + INDEX_CALCULUS_EXTRA_RELATIONS;
+    collector.size = 0;
+    atomic_init(&collector.done, 0);
+    collector.relation = malloc(collector.target * sizeof(sparseRow));
+    assert(collector.relation != NULL);
+    pthread_mutex_init(&collector.lock, NULL);
+    for (int i = 0; i < numberOfThreads; ++i) {
+        worker[i].collector = &collector;
+        worker[i].seed = nextRandom(&state);
+        pthread_create(&thread[i], NULL, collectRelations, &worker[i]);
+    }
+    for (int i = 0; i < numberOfThreads; ++i) {
+        pthread_join(thread[i], NULL);
+    }
+    pthread_mutex_destroy(&collector.lock);
+    free(thread);
+    free(worker);
+    context->relations = collector.size;
+
+    //solve the relations modulo every large prime power
+    partial = malloc(largeFactorSize * sizeof(long long int *));
+    assert(partial != NULL);
+    for (long long int f = 0; f < largeFactorSize; ++f) {
+        //The relations reduced modulo the prime power.
+        sparseRow *row = malloc(collector.size * sizeof(sparseRow));
+        assert(row != NULL);
+        //The generator of the subgroup of order largeFactor[f].
+        long long int gq = power(context->base, context->order / largeFactor[f], p);
+
+        for (long long int r = 0; r < collector.size; ++r) {
+            row[r].size = collector.relation[r].size;
+            row[r].column = malloc((row[r].size > 0 ? row[r].size : 1) * sizeof(long long int));
+            assert(row[r].column != NULL);
+            row[r].value = malloc((row[r].size > 0 ? row[r].size : 1) * sizeof(long long int));
+            assert(row[r].value != NULL);
+            memcpy(row[r].column, collector.relation[r].column, row[r].size * sizeof(long long int));
+            for (long long int i = 0; i < row[r].size; ++i) {
+                row[r].value[i] = mod(collector.relation[r].value[i], largeFactor[f]);
+            }
+            row[r].rhs = mod(collector.relation[r].rhs, largeFactor[f]);
+        }
+
+        partial[f] = malloc(context->factorBaseSize * sizeof(long long int));
+        assert(partial[f] != NULL);
+        solveSparseSystem(row, collector.size, context->factorBaseSize, largeFactor[f], partial[f]);
+
+        //a free column can spoil its pivot rows: keep only what is verified in the subgroup
+        for (long long int i = 0; i < context->factorBaseSize; ++i) {
+            if (partial[f][i] != -1 &&
+                power(gq, partial[f][i], p) != power(context->factorBase[i], context->order / largeFactor[f], p)) {
+                partial[f][i] = -1;
+            }
+        }
+
+        for (long long int r = 0; r < collector.size; ++r) {
+            free(row[r].column);
+            free(row[r].value);
+        }
+        free(row);
+    }
+
+    //combine the prime powers
+    for (long long int i = 0; i < context->factorBaseSize; ++i) {
+        //The logarithm modulo every large prime power.
+        long long int *residue = malloc(largeFactorSize * sizeof(long long int));
+        assert(residue != NULL);
+
+        context->logarithm[i] = 0;
+        for (long long int f = 0; f < largeFactorSize; ++f) {
+            residue[f] = partial[f][i];
+            if (residue[f] == -1) {
+                context->logarithm[i] = -1;
+            }
+        }
+        if (context->logarithm[i] != -1) {
+            context->logarithm[i] = chineseReminderTheorem(largeFactorSize, residue, largeFactor);
+        }
+        free(residue);
+    }
+
+    for (long long int f = 0; f < largeFactorSize; ++f) {
+        free(partial[f]);
+    }
+    for (long long int r = 0; r < collector.size; ++r) {
+        free(collector.relation[r].column);
+        free(collector.relation[r].value);
+    }
+    free(partial);
+    free(collector.relation);
+    free(largeFactor);
+    return context;
+}
+
+/**
+ * Computes the discrete logarithm modulo p of base number using the index-calculus precomputation.
+ * @details individual logarithm: b * base^s (mod p) for random s until it factors over the factor base (no special-q descent),
+ * @details then log(b) == sum(e_i * log(p_i)) - s (mod largeModulus).
+ * @details the residue modulo smallModulus comes from Pohlig-Hellman, the two are combined with the Chinese Reminder Theorem.
+ * @details b = base^x (mod p) where x = Log_(base) (b).
+ *
+ * @param context the index-calculus precomputation.
+ * @param b the number.
+ * @return the discrete logarithm modulo p - 1, -1 if b is 0 modulo p.
+ */
+long long int indexCalculusLogarithm(indexCalculus *context, long long int b) {
+    b = b < 0 ? modularReduction(mod(b, context->p), context->p) : mod(b, context->p);
+    if (b == 0) {
+        return -1;
+    }
+
+    //The residues of the logarithm.
+    long long int residue[2] = {0, 0};
+    //The module values of the residues.
+    long long int modules[2] = {context->largeModulus, context->smallModulus};
+    //The positions in the factor base of the prime factors.
+    long long int index[MAX_FACTORS];
+    //The exponents of the prime factors.
+    long long int exponent[MAX_FACTORS];
+    //The number of different prime factors.
+    long long int size = 0;
+    //The state of the pseudo-random generator.
+    unsigned long long int state = (unsigned long long int) b * 31 + (unsigned long long int) context->p;
+    //The discrete logarithm.
+    long long int res = 0;
+
+    //the small part: project on the subgroup of order smallModulus
+    if (context->smallModulus > 1) {
+        residue[1] = PohligHellmanAlgorithm(power(context->base, context->largeModulus, context->p),
+                                            power(b, context->largeModulus, context->p), context->p, context->smallModulus);
+    }
+
+    //the large part: random smoothing over the factor base
+    if (context->largeModulus > 1) {
+        for (long long int attempt = 0; attempt < INDEX_CALCULUS_SMOOTHING_LIMIT; ++attempt) {
+            //The random exponent.
+            long long int s = (long long int) (nextRandom(&state) % (unsigned long long int) context->order);
+            //1 if every prime factor has a known logarithm.
+            int known = 1;
+
+            if (!factorOverBase(context, product(b, power(context->base, s, context->p), context->p), index, exponent, &size)) {
+                continue;
+            }
+
+            residue[0] = sub(0, s, context->largeModulus);
+            for (long long int i = 0; i < size && known; ++i) {
+                if (context->logarithm[index[i]] == -1) {
+                    known = 0;
+                }
+                residue[0] = sum(residue[0], product(exponent[i], context->logarithm[index[i]], context->largeModulus), context->largeModulus);
+            }
+            if (!known) {
+                continue;
+            }
+
+            res = chineseReminderTheorem(2, residue, modules);
+            if (power(context->base, res, context->p) == b) {
+                return res;
+            }
+        }
+
+        return -1;
+    }
+
+    return residue[1];
+}
+
+/**
+ * Deletes an index-calculus precomputation.
+ *
+ * @param context the index-calculus precomputation to be deleted.
+ */
+void deleteIndexCalculus(indexCalculus *context) {
+    free(context->factorBase);
+    free(context->logarithm);
+    free(context);
+}
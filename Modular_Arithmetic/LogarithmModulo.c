@@ -0,0 +1,939 @@
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * The largest prime subgroup order solved with a baby-step table by the Pohlig-Hellman algorithm.
+ * @details above it the table would take more than 2^20 entries, so Pollard's rho is used instead.
+ */
+#define POHLIG_HELLMAN_TABLE_LIMIT (1LL << 40)
+
+/**
+ * The largest number of candidates tried when a rho collision does not fix the logarithm uniquely.
+ */
+#define POLLARD_RHO_CANDIDATE_LIMIT (1LL << 16)
+
+/**
+ * The number of multipliers of the r-adding walk used by Pollard's rho algorithm.
+ */
+#define RHO_MULTIPLIERS 20
+
+/**
+ * The widest interval scanned one power at a time by Pollard's kangaroo algorithm.
+ */
+#define KANGAROO_SCAN_LIMIT 1024
+
+/**
+ * The number of steps a thread makes before publishing them to the shared counters.
+ */
+#define PARALLEL_FLUSH_STEPS 4096
+
+/**
+ * The largest number of slots of the shared table of distinguished points.
+ */
+#define PARALLEL_TABLE_LIMIT (1LL << 26)
+
+/**
+ * The number of random starting points tried by Pollard's rho and kangaroo algorithms.
+ */
+#define POLLARD_ATTEMPTS 32
+
+
+/**
+ * Computes the hash of a residue, used to choose the step of a random walk.
+ *
+ * @param x the residue.
+ * @param salt the value that changes the walk between attempts.
+ * @return the hash of the residue.
+ */
+static unsigned long long int walkHash(long long int x, unsigned long long int salt) {
+    return (((unsigned long long int) x ^ salt) * 0x9E3779B97F4A7C15ULL) >> 32;
+}
+
+/**
+ * Struct --> represents the multipliers of an r-adding walk.
+ *
+ * @details value - the multipliers base^exponentBase * b^exponentB (mod m).
+ * @details exponentBase - the exponents of base.
+ * @details exponentB - the exponents of b.
+ */
+typedef struct AddingWalk {
+    long long int value[RHO_MULTIPLIERS];
+    long long int exponentBase[RHO_MULTIPLIERS];
+    long long int exponentB[RHO_MULTIPLIERS];
+}addingWalk;
+
+/**
+ * Draws the multipliers of an r-adding walk.
+ *
+ * @param walk the walk.
+ * @param base the logarithm base.
+ * @param b the number.
+ * @param m the module value.
+ * @param order the multiplicative order of base.
+ * @param state the state of the pseudo-random generator, updated.
+ */
+static void createAddingWalk(addingWalk *walk, long long int base, long long int b, long long int m,
+                             long long int order, unsigned long long int *state) {
+    for (int j = 0; j < RHO_MULTIPLIERS; ++j) {
+        walk->exponentBase[j] = (long long int) (nextRandom(state) % (unsigned long long int) order);
+        walk->exponentB[j] = (long long int) (nextRandom(state) % (unsigned long long int) order);
+        walk->value[j] = product(power(base, walk->exponentBase[j], m), power(b, walk->exponentB[j], m), m);
+    }
+}
+
+/**
+ * Moves an r-adding walk one step forward.
+ * @details x = base^u * b^v is multiplied by the multiplier chosen from a hash of x.
+ *
+ * @param walk the walk.
+ * @param x the position, updated.
+ * @param u the exponent of base, updated.
+ * @param v the exponent of b, updated.
+ * @param m the module value.
+ * @param order the multiplicative order of base.
+ */
+static void rhoStep(addingWalk *walk, long long int *x, long long int *u, long long int *v, long long int m, long long int order) {
+    //The multiplier chosen by the position.
+    int j = (int) (walkHash(*x, 0) % RHO_MULTIPLIERS);
+
+    *x = product(*x, walk->value[j], m);
+    *u = sum(*u, walk->exponentBase[j], order);
+    *v = sum(*v, walk->exponentB[j], order);
+}
+
+
+/**
+ * Computes the discrete logarithm from a collision of two walks.
+ * @details base^u1 * b^v1 == base^u2 * b^v2 --> (v2 - v1) * x == u1 - u2 (mod order).
+ * @details every one of the gcd(v2 - v1, order) solutions is checked.
+ *
+ * @param base the logarithm base.
+ * @param b the number.
+ * @param m the module value.
+ * @param order the multiplicative order of base.
+ * @param u1 the exponent of base of the first walk.
+ * @param v1 the exponent of b of the first walk.
+ * @param u2 the exponent of base of the second walk.
+ * @param v2 the exponent of b of the second walk.
+ * @return the discrete logarithm, -1 if the collision does not fix it.
+ */
+static long long int solveCollision(long long int base, long long int b, long long int m, long long int order,
+                                    long long int u1, long long int v1, long long int u2, long long int v2) {
+    //The difference of the exponents of b.
+    long long int r = sub(v2, v1, order);
+    //The difference of the exponents of base.
+    long long int t = sub(u1, u2, order);
+    //The gcd between r and the order.
+    long long int d = 0;
+    //The reduced order - order / d.
+    long long int n = 0;
+    //The solution modulo n.
+    long long int x0 = 0;
+
+    if (r == 0) {
+        return -1;
+    }
+    d = gcd(r, order);
+    if (t % d != 0 || d > POLLARD_RHO_CANDIDATE_LIMIT) {
+        return -1;
+    }
+    n = order / d;
+    x0 = n == 1 ? 0 : product(t / d, modularInverse(r / d, n), n);
+
+    for (long long int k = 0; k < d; ++k) {
+        if (power(base, x0 + k * n, m) == b) {
+            return x0 + k * n;
+        }
+    }
+
+    return -1;
+}
+
+
+/**
+ * Struct --> represents a slot of the lock-free table of distinguished points.
+ *
+ * @details key - the distinguished point, 0 if the slot is empty; it is claimed with a compare-and-swap.
+ * @details ready - 1 once u and v are written by the thread that claimed the slot.
+ * @details u - the exponent of base.
+ * @details v - the exponent of b.
+ */
+typedef struct DistinguishedPoint {
+    _Atomic long long int key;
+    atomic_int ready;
+    long long int u;
+    long long int v;
+}distinguishedPoint;
+
+/**
+ * Struct --> represents the state shared by the threads of a parallel discrete logarithm.
+ *
+ * @details base, b, m, order - the problem.
+ * @details walk - the r-adding walk followed by every thread.
+ * @details mask - the mask of the bits that must be 0 in a distinguished point.
+ * @details table - the distinguished points, with capacity slots.
+ * @details stepLimit - the number of steps after which the threads give up.
+ * @details result - the discrete logarithm, -1 while not found.
+ * @details done - 1 when the threads must stop.
+ * @details steps, distinguishedPoints, collisions - the shared counters.
+ */
+typedef struct ParallelLogarithm {
+    long long int base;
+    long long int b;
+    long long int m;
+    long long int order;
+    addingWalk walk;
+    long long int mask;
+    distinguishedPoint *table;
+    long long int capacity;
+    long long int stepLimit;
+    _Atomic long long int result;
+    atomic_int done;
+    _Atomic long long int steps;
+    _Atomic long long int distinguishedPoints;
+    _Atomic long long int collisions;
+}parallelLogarithm;
+
+/**
+ * Struct --> represents the argument of a thread of a parallel discrete logarithm.
+ *
+ * @details shared - the state shared by the threads.
+ * @details seed - the seed of the pseudo-random generator of the thread.
+ */
+typedef struct ParallelLogarithmWorker {
+    parallelLogarithm *shared;
+    unsigned long long int seed;
+}parallelLogarithmWorker;
+
+
+/**
+ * Creates the baby-step table of a base modulo m.
+ * @details with T baby steps, every logarithm takes at most order/T giant steps.
+ * @details T is the largest value whose hash table fits in memoryBudget bytes, never more than order.
+ * @details if memoryBudget is 0, T = sqrt(order) rounded up.
+ * @warning base must be coprime with m.
+ *
+ * @param base the logarithm base.
+ * @param m the module value.
+ * @param order the upper bound of the logarithms searched, m - 1 if base is a primitive root modulo a prime m.
+ * @param memoryBudget the maximum number of bytes used by the table, 0 for the square root default.
+ * @return the baby-step table.
+ */
+discreteLogarithmTable *createDiscreteLogarithmTable(long long int base, long long int m, long long int order, long long int memoryBudget) {
+    assert(m > 1);
+    assert(order > 0);
+    assert(memoryBudget >= 0);
+
+    //The baby-step table.
+    discreteLogarithmTable *table = malloc(sizeof(discreteLogarithmTable));
+    assert(table != NULL);
+    //The current baby step.
+    long long int ajValue = 1;
+    //The number of baby steps.
+    long long int T = 0;
+
+    base = base < 0 ? modularReduction(mod(base, m), m) : mod(base, m);
+
+    if (memoryBudget == 0) {
+        //the square root of order rounded up
+        T = (long long int) ceil(sqrt((double) order));
+        while (T > 1 && (T - 1) * (T - 1) >= order) {
+            T--;
+        }
+        while (T * T < order) {
+            T++;
+        }
+    }
+    else {
+        //the hash table keeps the load factor at most 1/2, so T entries take 2T slots
+        T = 1;
+        while (4 * T * (long long int) sizeof(hashTableEntry) <= memoryBudget && T < order) {
+            T *= 2;
+        }
+    }
+    if (T > order) {
+        T = order;
+    }
+
+    table->base = base;
+    table->m = m;
+    table->order = order;
+    table->babySteps = T;
+    table->table = createHashTable(T);
+
+    //compute the baby steps, each one from the previous
+    for (long long int j = 0; j < T; ++j) {
+        insertHashTable(table->table, ajValue, j);
+        ajValue = product(ajValue, base, m);
+    }
+
+    //base^(-T) (mod m)
+    table->giantStep = power(modularInverse(base, m), T, m);
+
+    return table;
+}
+
+/**
+ * Computes the discrete logarithm of a number using a baby-step table.
+ * @details Baby-Step Giant-Step algorithm.
+ * @details b = base^x (mod m) where x = Log_(base) (b) and 0 <= x < order.
+ *
+ * @param table the baby-step table.
+ * @param b the number.
+ * @return the discrete logarithm, -1 if it does not exist.
+ */
+long long int discreteLogarithmFromTable(discreteLogarithmTable *table, long long int b) {
+    //The giant step - b*base^(-Tk) (mod m).
+    long long int baNk = b < 0 ? modularReduction(mod(b, table->m), table->m) : mod(b, table->m);
+    //The position in the baby steps.
+    long long int ajPos = 0;
+    //The number of giant steps needed to cover the order.
+    long long int giantSteps = (table->order + table->babySteps - 1) / table->babySteps;
+
+    for (long long int i = 0; i < giantSteps; ++i) {
+        if (searchHashTable(table->table, baNk, &ajPos)) {
+            //the last giant step can overshoot the order
+            return ajPos + table->babySteps * i < table->order ? ajPos + table->babySteps * i : -1;
+        }
+        baNk = product(baNk, table->giantStep, table->m);
+    }
+
+    return -1;
+}
+
+/**
+ * Computes the discrete logarithms of many numbers using a baby-step table.
+ * @details Baby-Step Giant-Step algorithm.
+ *
+ * @param table the baby-step table.
+ * @param numberOfValues the number of numbers.
+ * @param b the numbers.
+ * @param res the discrete logarithms, -1 where it does not exist.
+ */
+void discreteLogarithmBatch(discreteLogarithmTable *table, long long int numberOfValues, long long int *b, long long int *res) {
+    for (long long int i = 0; i < numberOfValues; ++i) {
+        res[i] = discreteLogarithmFromTable(table, b[i]);
+    }
+}
+
+/**
+ * Saves a baby-step table to a file.
+ *
+ * @param table the baby-step table.
+ * @param fileName the name of the file.
+ */
+void saveDiscreteLogarithmTable(discreteLogarithmTable *table, const char *fileName) {
+    //The file.
+    FILE *file = fopen(fileName, "wb");
+    assert(file != NULL && "the file cannot be opened");
+
+    fwrite(&table->base, sizeof(long long int), 1, file);
+    fwrite(&table->m, sizeof(long long int), 1, file);
+    fwrite(&table->order, sizeof(long long int), 1, file);
+    fwrite(&table->babySteps, sizeof(long long int), 1, file);
+    fwrite(&table->giantStep, sizeof(long long int), 1, file);
+    writeHashTable(table->table, file);
+
+    fclose(file);
+}
+
+/**
+ * Loads a baby-step table from a file.
+ * @warning the file must have been written by saveDiscreteLogarithmTable.
+ *
+ * @param fileName the name of the file.
+ * @return the baby-step table.
+ */
+discreteLogarithmTable *loadDiscreteLogarithmTable(const char *fileName) {
+    //The file.
+    FILE *file = fopen(fileName, "rb");
+    assert(file != NULL && "the file cannot be opened");
+    //The baby-step table.
+    discreteLogarithmTable *table = malloc(sizeof(discreteLogarithmTable));
+    assert(table != NULL);
+    //The number of elements read.
+    size_t read = 0;
+
+    read += fread(&table->base, sizeof(long long int), 1, file);
+    read += fread(&table->m, sizeof(long long int), 1, file);
+    read += fread(&table->order, sizeof(long long int), 1, file);
+    read += fread(&table->babySteps, sizeof(long long int), 1, file);
+    read += fread(&table->giantStep, sizeof(long long int), 1, file);
+    assert(read == 5 && "the file is not a baby-step table");
+    table->table = readHashTable(file);
+
+    fclose(file);
+    return table;
+}
+
+/**
+ * Deletes a baby-step table.
+ *
+ * @param table the baby-step table to be deleted.
+ */
+void deleteDiscreteLogarithmTable(discreteLogarithmTable *table) {
+    deleteHashTable(table->table);
+    free(table);
+}
+
+/**
+ * Computes the discrete logarithm modulo m of base number.
+ * @details Pohlig-Hellman algorithm: the logarithm is computed modulo every prime power q^e dividing the order,
+ * @details one base-q digit at a time in the subgroup of order q,
+ * @details with Baby-Step Giant-Step or, when q is too large for its table, with Pollard's rho,
+ * @details then the results are combined with the Chinese Reminder Theorem.
+ * @details O(sum(e * sqrt(q))) multiplications, fast when the order is smooth.
+ * @details b = base^x (mod m) where x = Log_(base) (b) and 0 <= x < order.
+ * @warning order must be the multiplicative order of base modulo m, m - 1 if base is a primitive root modulo a prime m.
+ *
+ * @param base the logarithm base.
+ * @param b the number.
+ * @param m the module value.
+ * @param order the multiplicative order of base modulo m.
+ * @return the discrete logarithm modulo order, -1 if it does not exist.
+ */
+long long int PohligHellmanAlgorithm(long long int base, long long int b, long long int m, long long int order) {
+    assert(order > 0);
+
+    base = base < 0 ? modularReduction(mod(base, m), m) : mod(base, m);
+    b = b < 0 ? modularReduction(mod(b, m), m) : mod(b, m);
+
+    //The number of prime factors of the order.
+    long long int factorSize = 0;
+    //The prime factors of the order.
+    long long int *factor = factorisation(order, &factorSize);
+    //The logarithm modulo every prime power.
+    long long int *x = malloc((factorSize > 0 ? factorSize : 1) * sizeof(long long int));
+    assert(x != NULL);
+    //The prime powers q^e dividing the order.
+    long long int *qe = malloc((factorSize > 0 ? factorSize : 1) * sizeof(long long int));
+    assert(qe != NULL);
+    //The discrete logarithm.
+    long long int res = 0;
+
+    for (long long int i = 0; i < factorSize; ++i) {
+        //The prime.
+        long long int q = factor[i];
+        //The exponent of q in the order.
+        long long int e = 0;
+        //The base of the subgroup of order q^e - base^(order/q^e).
+        long long int gi = 0;
+        //The number projected in the subgroup of order q^e - b^(order/q^e).
+        long long int hi = 0;
+        //The generator of the subgroup of order q - gi^(q^(e-1)).
+        long long int gamma = 0;
+        //The inverse of gi.
+        long long int giInverse = 0;
+        //The number with the known digits removed - hi * gi^(-x[i]).
+        long long int h = 0;
+        //The baby-step table of gamma.
+        discreteLogarithmTable *table = NULL;
+        //The value of q^k.
+        long long int qk = 1;
+
+        qe[i] = 1;
+        while (order / qe[i] % q == 0) {
+            qe[i] *= q;
+            e++;
+        }
+
+        gi = power(base, order / qe[i], m);
+        hi = power(b, order / qe[i], m);
+        gamma = power(gi, qe[i] / q, m);
+        giInverse = modularInverse(gi, m);
+        h = hi;
+        if (q <= POHLIG_HELLMAN_TABLE_LIMIT) {
+            table = createDiscreteLogarithmTable(gamma, m, q, 0);
+        }
+
+        //compute the base-q digits of the logarithm modulo q^e
+        x[i] = 0;
+        for (long long int k = 0; k < e; ++k) {
+            //The number with the known digits removed, raised to q^(e-1-k) - it lies in the subgroup of order q.
+            long long int hk = power(h, qe[i] / (qk * q), m);
+            //The k-th digit.
+            long long int d = 0;
+
+            d = table != NULL ? discreteLogarithmFromTable(table, hk) : PollardRhoAlgorithm(gamma, hk, m, q);
+            if (d == -1) {
+                //b is not in the subgroup generated by base
+                if (table != NULL) {
+                    deleteDiscreteLogarithmTable(table);
+                }
+                free(factor);
+                free(x);
+                free(qe);
+                return -1;
+            }
+
+            //remove the new digit: h = h * gi^(-d * q^k)
+            if (d > 0) {
+                h = product(h, power(giInverse, d * qk, m), m);
+            }
+            x[i] += d * qk;
+            qk *= q;
+        }
+
+        if (table != NULL) {
+            deleteDiscreteLogarithmTable(table);
+        }
+    }
+
+    if (factorSize > 0) {
+        res = chineseReminderTheorem(factorSize, x, qe);
+    }
+
+    free(factor);
+    free(x);
+    free(qe);
+
+    //b may still be outside the subgroup generated by base
+    return power(base, res, m) == b ? res : -1;
+}
+
+/**
+ * Computes the discrete logarithm modulo m of base number.
+ * @details Pollard's rho algorithm with Brent's cycle detection, O(sqrt(order)) multiplications and O(1) memory.
+ * @details Teske's r-adding walk: x = base^u * b^v is multiplied by one of 20 random base^a * b^c chosen from a hash of x.
+ * @details a collision gives u1 + x*v1 == u2 + x*v2 (mod order), solved for every gcd(v2 - v1, order) candidate.
+ * @details b = base^x (mod m) where x = Log_(base) (b) and 0 <= x < order.
+ * @warning order must be the multiplicative order of base modulo m, best when it is prime.
+ *
+ * @param base the logarithm base.
+ * @param b the number.
+ * @param m the module value.
+ * @param order the multiplicative order of base modulo m.
+ * @return the discrete logarithm modulo order, -1 if it does not exist.
+ */
+long long int PollardRhoAlgorithm(long long int base, long long int b, long long int m, long long int order) {
+    assert(order > 0);
+
+    base = base < 0 ? modularReduction(mod(base, m), m) : mod(base, m);
+    b = b < 0 ? modularReduction(mod(b, m), m) : mod(b, m);
+
+    //The state of the pseudo-random generator.
+    unsigned long long int state = (unsigned long long int) base * 31 + (unsigned long long int) b;
+
+    //tiny groups are not worth a walk
+    if (order < 16) {
+        for (long long int x = 0, bx = 1; x < order; ++x, bx = product(bx, base, m)) {
+            if (bx == b) {
+                return x;
+            }
+        }
+        return -1;
+    }
+
+    for (long long int attempt = 0; attempt < POLLARD_ATTEMPTS; ++attempt) {
+        //The multipliers of the walk.
+        addingWalk walk;
+        //The tortoise - base^u1 * b^v1.
+        long long int x1 = 0, u1 = 0, v1 = 0;
+        //The hare - base^u2 * b^v2.
+        long long int x2 = 0, u2 = 0, v2 = 0;
+        //The length of the current power-of-2 window.
+        long long int window = 1;
+        //The number of steps made by the hare in the current window.
+        long long int steps = 0;
+        //The candidate logarithm.
+        long long int x = 0;
+
+        createAddingWalk(&walk, base, b, m, order, &state);
+        u1 = (long long int) (nextRandom(&state) % (unsigned long long int) order);
+        v1 = (long long int) (nextRandom(&state) % (unsigned long long int) order);
+        x1 = product(power(base, u1, m), power(b, v1, m), m);
+        x2 = x1;
+        u2 = u1;
+        v2 = v1;
+        rhoStep(&walk, &x2, &u2, &v2, m, order);
+        steps = 1;
+
+        //Brent: the tortoise teleports to the hare at every power of 2
+        while (x1 != x2) {
+            if (steps == window) {
+                x1 = x2;
+                u1 = u2;
+                v1 = v2;
+                window *= 2;
+                steps = 0;
+            }
+            rhoStep(&walk, &x2, &u2, &v2, m, order);
+            steps++;
+        }
+
+        x = solveCollision(base, b, m, order, u1, v1, u2, v2);
+        if (x != -1) {
+            return x;
+        }
+    }
+
+    //b is not in the subgroup generated by base
+    return -1;
+}
+
+/**
+ * Computes the discrete logarithm modulo m of base number, knowing that it lies in an interval.
+ * @details Pollard's kangaroo (lambda) algorithm, O(sqrt(upper - lower)) multiplications and O(log(upper - lower)) memory.
+ * @details a tame kangaroo jumps from base^upper and sets a trap, a wild kangaroo jumps from b until it falls in it.
+ * @details the jumps are powers of 2 chosen from a hash of the position, with mean sqrt(upper - lower) / 2.
+ * @details b = base^x (mod m) where x = Log_(base) (b) and lower <= x <= upper.
+ *
+ * @param base the logarithm base.
+ * @param b the number.
+ * @param m the module value.
+ * @param lower the smallest possible logarithm.
+ * @param upper the largest possible logarithm.
+ * @return the discrete logarithm, -1 if it was not found in the interval.
+ */
+long long int PollardKangarooAlgorithm(long long int base, long long int b, long long int m, long long int lower, long long int upper) {
+    assert(0 <= lower && lower <= upper);
+
+    base = base < 0 ? modularReduction(mod(base, m), m) : mod(base, m);
+    b = b < 0 ? modularReduction(mod(b, m), m) : mod(b, m);
+
+    //The width of the interval.
+    long long int w = upper - lower;
+    //The square root of the width rounded up.
+    long long int root = (long long int) ceil(sqrt((double) w));
+    //The number of different jumps - 2^0 ... 2^(k-1).
+    int k = 1;
+    //The values of base^(2^j) (mod m).
+    long long int jump[63];
+    //The number of jumps of the tame kangaroo.
+    long long int tameJumps = 2 * root + 4;
+    //The state of the pseudo-random generator.
+    unsigned long long int state = (unsigned long long int) base * 31 + (unsigned long long int) b;
+
+    //the wild kangaroo starts from b * base^(-lower), whose logarithm lies in [0, w]
+    b = product(b, power(modularInverse(base, m), lower, m), m);
+
+    //short intervals are not worth a jump
+    if (w < KANGAROO_SCAN_LIMIT) {
+        for (long long int x = 0, bx = 1; x <= w; ++x, bx = product(bx, base, m)) {
+            if (bx == b) {
+                return lower + x;
+            }
+        }
+        return -1;
+    }
+
+    //the mean jump (2^k - 1) / k must reach sqrt(w) / 2
+    while (k < 62 && ((1LL << k) - 1) / k < root / 2) {
+        k++;
+    }
+    jump[0] = base;
+    for (int j = 1; j < k; ++j) {
+        jump[j] = product(jump[j - 1], jump[j - 1], m);
+    }
+
+    for (long long int attempt = 0; attempt < POLLARD_ATTEMPTS; ++attempt) {
+        //The value that changes the jumps between attempts.
+        unsigned long long int salt = nextRandom(&state);
+        //The position of the tame kangaroo.
+        long long int xT = power(base, w, m);
+        //The distance travelled by the tame kangaroo.
+        long long int dT = 0;
+        //The position of the wild kangaroo.
+        long long int xW = b;
+        //The distance travelled by the wild kangaroo.
+        long long int dW = 0;
+
+        //the tame kangaroo sets the trap
+        for (long long int i = 0; i < tameJumps; ++i) {
+            //The jump chosen by the position.
+            int j = (int) (walkHash(xT, salt) % (unsigned long long int) k);
+
+            xT = product(xT, jump[j], m);
+            dT += 1LL << j;
+        }
+
+        //the wild kangaroo runs until it falls in the trap or passes it
+        while (dW <= w + dT) {
+            if (xW == xT) {
+                //the trap can also be reached through a multiple of the order of base
+                if (w + dT - dW <= w) {
+                    return lower + w + dT - dW;
+                }
+                break;
+            }
+
+            //The jump chosen by the position.
+            int j = (int) (walkHash(xW, salt) % (unsigned long long int) k);
+
+            xW = product(xW, jump[j], m);
+            dW += 1LL << j;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Stores a distinguished point in the shared table, or finds the walk that reached it first.
+ * @details lock-free: the slot is claimed with a compare-and-swap on the key, the exponents are published with ready.
+ * @details once the table is full the point is only looked up: a walk can still meet a stored one, new points are dropped.
+ *
+ * @param shared the state shared by the threads.
+ * @param x the distinguished point.
+ * @param u the exponent of base.
+ * @param v the exponent of b.
+ * @param otherU the exponent of base of the walk that reached x first, if any.
+ * @param otherV the exponent of b of the walk that reached x first, if any.
+ * @return 1 if x was already stored, 0 otherwise.
+ */
+static int storeDistinguishedPoint(parallelLogarithm *shared, long long int x, long long int u, long long int v,
+                                   long long int *otherU, long long int *otherV) {
+    //The mask used to wrap around the table.
+    long long int mask = shared->capacity - 1;
+    //The position of the point.
+    long long int position = (long long int) (walkHash(x, 0x5BD1E995ULL) & (unsigned long long int) mask);
+    //1 if the table is full, then x is only looked up and never stored.
+    int full = atomic_load_explicit(&shared->distinguishedPoints, memory_order_relaxed) >= shared->capacity / 4 * 3;
+
+    while (1) {
+        //The key expected in an empty slot.
+        long long int expected = 0;
+
+        if (full) {
+            expected = atomic_load(&shared->table[position].key);
+            if (expected == 0) {
+                return 0;
+            }
+        } else if (atomic_compare_exchange_strong(&shared->table[position].key, &expected, x)) {
+            shared->table[position].u = u;
+            shared->table[position].v = v;
+            atomic_store_explicit(&shared->table[position].ready, 1, memory_order_release);
+            atomic_fetch_add_explicit(&shared->distinguishedPoints, 1, memory_order_relaxed);
+            return 0;
+        }
+        if (expected == x) {
+            while (!atomic_load_explicit(&shared->table[position].ready, memory_order_acquire)) {
+            }
+            *otherU = shared->table[position].u;
+            *otherV = shared->table[position].v;
+            return 1;
+        }
+        position = (position + 1) & mask;
+    }
+}
+
+/**
+ * Runs the walks of a thread of a parallel discrete logarithm.
+ * @details a walk restarts from a new random point after each distinguished point,
+ * @details or after 20 times the expected distance between two of them, in case it is trapped in a cycle.
+ *
+ * @param argument the argument of the thread - parallelLogarithmWorker.
+ * @return NULL.
+ */
+static void *parallelLogarithmThread(void *argument) {
+    //The argument of the thread.
+    parallelLogarithmWorker *worker = argument;
+    //The state shared by the threads.
+    parallelLogarithm *shared = worker->shared;
+    //The state of the pseudo-random generator.
+    unsigned long long int state = worker->seed;
+    //The longest walk without distinguished points.
+    long long int walkLimit = 20 * (shared->mask + 1);
+    //The steps not yet published to the shared counter.
+    long long int localSteps = 0;
+
+    while (!atomic_load_explicit(&shared->done, memory_order_relaxed)) {
+        //The exponent of base.
+        long long int u = (long long int) (nextRandom(&state) % (unsigned long long int) shared->order);
+        //The exponent of b.
+        long long int v = (long long int) (nextRandom(&state) % (unsigned long long int) shared->order);
+        //The position - base^u * b^v.
+        long long int x = product(power(shared->base, u, shared->m), power(shared->b, v, shared->m), shared->m);
+
+        for (long long int length = 0; length < walkLimit; ++length) {
+            if ((x & shared->mask) == 0) {
+                //The exponent of base of the other walk.
+                long long int otherU = 0;
+                //The exponent of b of the other walk.
+                long long int otherV = 0;
+
+                if (storeDistinguishedPoint(shared, x, u, v, &otherU, &otherV) && (otherU != u || otherV != v)) {
+                    //The candidate logarithm.
+                    long long int res = solveCollision(shared->base, shared->b, shared->m, shared->order, u, v, otherU, otherV);
+
+                    atomic_fetch_add_explicit(&shared->collisions, 1, memory_order_relaxed);
+                    if (res != -1) {
+                        atomic_store(&shared->result, res);
+                        atomic_store(&shared->done, 1);
+                    }
+                }
+                break;
+            }
+
+            rhoStep(&shared->walk, &x, &u, &v, shared->m, shared->order);
+            localSteps++;
+
+            if (localSteps == PARALLEL_FLUSH_STEPS) {
+                if (atomic_fetch_add_explicit(&shared->steps, localSteps, memory_order_relaxed) + localSteps > shared->stepLimit) {
+                    atomic_store(&shared->done, 1);
+                }
+                localSteps = 0;
+                if (atomic_load_explicit(&shared->done, memory_order_relaxed)) {
+                    break;
+                }
+            }
+        }
+    }
+
+    atomic_fetch_add_explicit(&shared->steps, localSteps, memory_order_relaxed);
+    return NULL;
+}
+
+/**
+ * Fills the statistics of a parallel discrete logarithm.
+ *
+ * @param shared the state shared by the threads.
+ * @param start the time of the start.
+ * @param statistics the statistics to fill.
+ */
+static void readParallelStatistics(parallelLogarithm *shared, struct timespec *start, parallelLogarithmStatistics *statistics) {
+    //The current time.
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    statistics->steps = atomic_load(&shared->steps);
+    statistics->distinguishedPoints = atomic_load(&shared->distinguishedPoints);
+    statistics->collisions = atomic_load(&shared->collisions);
+    statistics->seconds = (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+    statistics->stepsPerSecond = statistics->seconds > 0 ? (double) statistics->steps / statistics->seconds : 0;
+}
+
+/**
+ * Computes the discrete logarithm modulo m of base number using many threads.
+ * @details parallel Pollard's rho algorithm with distinguished points (van Oorschot-Wiener).
+ * @details every thread runs the same r-adding walk from random starting points and stores the points x with
+ * @details (x & distinguishedMask) == 0 in a lock-free hash table shared by all the threads:
+ * @details two walks that merge reach the same distinguished point and their exponents give the logarithm.
+ * @details b = base^x (mod m) where x = Log_(base) (b) and 0 <= x < order.
+ * @warning order must be the multiplicative order of base modulo m, best when it is prime.
+ *
+ * @param base the logarithm base.
+ * @param b the number.
+ * @param m the module value.
+ * @param order the multiplicative order of base modulo m.
+ * @param numberOfThreads the number of threads.
+ * @param distinguishedMask the mask of the bits that must be 0 in a distinguished point, e.g. (1 << 12) - 1.
+ * @param progress the function called about once per second with the current statistics - NOT necessary.
+ * @param statistics the final statistics - NOT necessary.
+ * @return the discrete logarithm modulo order, -1 if it does not exist.
+ */
+long long int parallelDiscreteLogarithm(long long int base, long long int b, long long int m, long long int order,
+                                        int numberOfThreads, long long int distinguishedMask,
+                                        void (*progress)(parallelLogarithmStatistics *statistics),
+                                        parallelLogarithmStatistics *statistics) {
+    assert(order > 0);
+    assert(numberOfThreads > 0);
+    assert(distinguishedMask >= 0);
+
+    base = base < 0 ? modularReduction(mod(base, m), m) : mod(base, m);
+    b = b < 0 ? modularReduction(mod(b, m), m) : mod(b, m);
+
+    //The state shared by the threads.
+    parallelLogarithm shared;
+    //The threads.
+    pthread_t *thread = malloc(numberOfThreads * sizeof(pthread_t));
+    assert(thread != NULL);
+    //The arguments of the threads.
+    parallelLogarithmWorker *worker = malloc(numberOfThreads * sizeof(parallelLogarithmWorker));
+    assert(worker != NULL);
+    //The state of the pseudo-random generator.
+    unsigned long long int state = (unsigned long long int) base * 31 + (unsigned long long int) b;
+    //The square root of the order rounded up.
+    long long int root = (long long int) ceil(sqrt((double) order));
+    //The expected number of distinguished points.
+    long long int expected = root / (distinguishedMask + 1) + 1;
+    //The time of the start.
+    struct timespec start;
+    //The time between two progress reports.
+    struct timespec pause = {0, 10000000};
+    //The number of pauses since the last progress report.
+    int pauses = 0;
+    //The current statistics.
+    parallelLogarithmStatistics current;
+    //The discrete logarithm.
+    long long int res = 0;
+
+    //tiny groups are not worth the threads
+    if (order < 16) {
+        free(thread);
+        free(worker);
+        res = PollardRhoAlgorithm(base, b, m, order);
+        if (statistics != NULL) {
+            statistics->steps = order;
+            statistics->distinguishedPoints = 0;
+            statistics->collisions = 0;
+            statistics->seconds = 0;
+            statistics->stepsPerSecond = 0;
+        }
+        return res;
+    }
+
+    shared.base = base;
+    shared.b = b;
+    shared.m = m;
+    shared.order = order;
+    shared.mask = distinguishedMask;
+    createAddingWalk(&shared.walk, base, b, m, order, &state);
+    shared.stepLimit = 64 * root + 64 * (distinguishedMask + 1) * numberOfThreads;
+    atomic_init(&shared.result, -1);
+    atomic_init(&shared.done, 0);
+    atomic_init(&shared.steps, 0);
+    atomic_init(&shared.distinguishedPoints, 0);
+    atomic_init(&shared.collisions, 0);
+
+    //room for 4 times the expected distinguished points
+    shared.capacity = 1024;
+    while (shared.capacity < 4 * expected && shared.capacity < PARALLEL_TABLE_LIMIT) {
+        shared.capacity *= 2;
+    }
+    shared.table = malloc(shared.capacity * sizeof(distinguishedPoint));
+    assert(shared.table != NULL);
+    for (long long int i = 0; i < shared.capacity; ++i) {
+        atomic_init(&shared.table[i].key, 0);
+        atomic_init(&shared.table[i].ready, 0);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < numberOfThreads; ++i) {
+        worker[i].shared = &shared;
+        worker[i].seed = nextRandom(&state);
+        pthread_create(&thread[i], NULL, parallelLogarithmThread, &worker[i]);
+    }
+
+    //the calling thread reports the progress while the workers run
+    while (!atomic_load(&shared.done)) {
+        nanosleep(&pause, NULL);
+        if (++pauses == 100 && progress != NULL) {
+            readParallelStatistics(&shared, &start, &current);
+            progress(&current);
+            pauses = 0;
+        }
+    }
+
+    for (int i = 0; i < numberOfThreads; ++i) {
+        pthread_join(thread[i], NULL);
+    }
+
+    res = atomic_load(&shared.result);
+    if (statistics != NULL) {
+        readParallelStatistics(&shared, &start, statistics);
+    }
+
+    free(shared.table);
+    free(thread);
+    free(worker);
+    return res;
+}
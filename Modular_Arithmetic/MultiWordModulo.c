@@ -0,0 +1,744 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * The largest number of 64-bit words of a multi-word number, 512 bits.
+ */
+#define MAX_WORDS 8
+
+/**
+ * The number of Miller-Rabin bases, the first prime numbers.
+ */
+#define MILLER_RABIN_BASES 20
+
+/**
+ * The word kernels are inlined in every width, so their loops run a constant number of times and are unrolled.
+ */
+#define WORD_KERNEL static inline __attribute__((always_inline))
+
+
+/**
+ * The prime numbers used as Miller-Rabin bases and trial divisors.
+ */
+static const unsigned long long int SMALL_PRIMES[MILLER_RABIN_BASES] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43,
+                                                                        47, 53, 59, 61, 67, 71};
+
+
+/**
+ * Computes the sum of two multi-word numbers.
+ *
+ * @param res the sum, it may be a or b.
+ * @param a the first addend.
+ * @param b the second addend.
+ * @param words the number of words.
+ * @return the carry out of the last word.
+ */
+WORD_KERNEL unsigned long long int wordsSum(unsigned long long int *res, const unsigned long long int *a,
+                                            const unsigned long long int *b, long long int words) {
+    //The carry.
+    unsigned __int128 carry = 0;
+
+    for (long long int i = 0; i < words; ++i) {
+        carry += (unsigned __int128) a[i] + b[i];
+        res[i] = (unsigned long long int) carry;
+        carry >>= 64;
+    }
+
+    return (unsigned long long int) carry;
+}
+
+/**
+ * Computes the difference of two multi-word numbers.
+ *
+ * @param res the difference, it may be a or b.
+ * @param a the minuend.
+ * @param b the subtrahend.
+ * @param words the number of words.
+ * @return the borrow out of the last word.
+ */
+WORD_KERNEL unsigned long long int wordsSub(unsigned long long int *res, const unsigned long long int *a,
+                                            const unsigned long long int *b, long long int words) {
+    //The borrow.
+    unsigned long long int borrow = 0;
+
+    for (long long int i = 0; i < words; ++i) {
+        //The minuend word.
+        unsigned long long int x = a[i];
+        //The subtrahend word, with the borrow.
+        unsigned long long int y = b[i] + borrow;
+
+        //y overflows only if b[i] is 2^64 - 1 and there is a borrow
+        borrow = (y < borrow) | (x < y);
+        res[i] = x - y;
+    }
+
+    return borrow;
+}
+
+/**
+ * Compares two multi-word numbers.
+ *
+ * @param a the first number.
+ * @param b the second number.
+ * @param words the number of words.
+ * @return 1 if a > b, -1 if a < b, 0 if they are equal.
+ */
+WORD_KERNEL int wordsCompare(const unsigned long long int *a, const unsigned long long int *b, long long int words) {
+    for (long long int i = words - 1; i >= 0; --i) {
+        if (a[i] != b[i]) {
+            return a[i] > b[i] ? 1 : -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Checks if a multi-word number is zero.
+ *
+ * @param a the number.
+ * @param words the number of words.
+ * @return 1 if the number is zero, 0 otherwise.
+ */
+WORD_KERNEL int wordsIsZero(const unsigned long long int *a, long long int words) {
+    //The or of the words.
+    unsigned long long int any = 0;
+
+    for (long long int i = 0; i < words; ++i) {
+        any |= a[i];
+    }
+
+    return any == 0;
+}
+
+/**
+ * Shifts a multi-word number right by one bit.
+ *
+ * @param a the number, shifted in place.
+ * @param top the bit shifted into the most significant word.
+ * @param words the number of words.
+ */
+WORD_KERNEL void wordsHalve(unsigned long long int *a, unsigned long long int top, long long int words) {
+    for (long long int i = 0; i < words - 1; ++i) {
+        a[i] = (a[i] >> 1) | (a[i + 1] << 63);
+    }
+    a[words - 1] = (a[words - 1] >> 1) | (top << 63);
+}
+
+/**
+ * Computes the sum modulo m of two reduced multi-word numbers.
+ * @details a + b may carry out of the words when m is close to 2^(64 * words), the carry means it is above m.
+ *
+ * @param res the sum, it may be a or b.
+ * @param a the first addend, lower than m.
+ * @param b the second addend, lower than m.
+ * @param m the module value.
+ * @param words the number of words.
+ */
+WORD_KERNEL void wordsSumModulo(unsigned long long int *res, const unsigned long long int *a, const unsigned long long int *b,
+                                const unsigned long long int *m, long long int words) {
+    //The carry of the sum.
+    unsigned long long int carry = wordsSum(res, a, b, words);
+
+    if (carry || wordsCompare(res, m, words) >= 0) {
+        wordsSub(res, res, m, words);
+    }
+}
+
+/**
+ * Computes the difference modulo m of two reduced multi-word numbers.
+ *
+ * @param res the difference, it may be a or b.
+ * @param a the minuend, lower than m.
+ * @param b the subtrahend, lower than m.
+ * @param m the module value.
+ * @param words the number of words.
+ */
+WORD_KERNEL void wordsSubModulo(unsigned long long int *res, const unsigned long long int *a, const unsigned long long int *b,
+                                const unsigned long long int *m, long long int words) {
+    if (wordsSub(res, a, b, words)) {
+        wordsSum(res, res, m, words);
+    }
+}
+
+/**
+ * Computes the Montgomery product of two multi-word numbers.
+ * @details coarsely integrated operand scanning (CIOS): res = a * b * 2^(-64 * words) (mod m),
+ * @details one word of b and one reduction step per row, so the partial product never exceeds words + 2 words.
+ *
+ * @param res the product, lower than m, it may be a or b.
+ * @param a the first factor, lower than m.
+ * @param b the second factor, lower than m.
+ * @param m the odd module value.
+ * @param inverse -m^(-1) (mod 2^64).
+ * @param words the number of words.
+ */
+WORD_KERNEL void wordsMontgomeryProduct(unsigned long long int *res, const unsigned long long int *a,
+                                        const unsigned long long int *b, const unsigned long long int *m,
+                                        unsigned long long int inverse, long long int words) {
+    //The partial product.
+    unsigned long long int t[MAX_WORDS + 2] = {0};
+
+    for (long long int i = 0; i < words; ++i) {
+        //The carry of the row.
+        unsigned __int128 carry = 0;
+        //The multiple of m that clears the lowest word.
+        unsigned long long int q = 0;
+
+        //t += a * b[i]
+        for (long long int j = 0; j < words; ++j) {
+            carry += (unsigned __int128) a[j] * b[i] + t[j];
+            t[j] = (unsigned long long int) carry;
+            carry >>= 64;
+        }
+        carry += t[words];
+        t[words] = (unsigned long long int) carry;
+        t[words + 1] = (unsigned long long int) (carry >> 64);
+
+        //t = (t + q * m) / 2^64
+        q = t[0] * inverse;
+        carry = ((unsigned __int128) q * m[0] + t[0]) >> 64;
+        for (long long int j = 1; j < words; ++j) {
+            carry += (unsigned __int128) q * m[j] + t[j];
+            t[j - 1] = (unsigned long long int) carry;
+            carry >>= 64;
+        }
+        carry += t[words];
+        t[words - 1] = (unsigned long long int) carry;
+        t[words] = t[words + 1] + (unsigned long long int) (carry >> 64);
+    }
+
+    //t < 2m
+    if (t[words] || wordsCompare(t, m, words) >= 0) {
+        wordsSub(t, t, m, words);
+    }
+    for (long long int i = 0; i < words; ++i) {
+        res[i] = t[i];
+    }
+}
+
+/**
+ * Computes the Montgomery precomputation of a multi-word module value.
+ * @details inverse = -m^(-1) (mod 2^64) by Newton's iteration, every step doubles the correct bits of m^(-1),
+ * @details one = R (mod m) by doubling 1, then with 64 * words = t * 2^s and t odd, R * 2^t (mod m) by doubling one,
+ * @details and s Montgomery squares R * 2^x --> R * 2^(2x) give r2 = R * 2^(64 * words) = R^2 (mod m).
+ *
+ * @param m the odd module value, greater than 1.
+ * @param r2 the square of the Montgomery radix modulo m.
+ * @param one the Montgomery form of 1.
+ * @param words the number of words.
+ * @return -m^(-1) (mod 2^64).
+ */
+WORD_KERNEL unsigned long long int wordsMontgomeryPrecomputation(const unsigned long long int *m, unsigned long long int *r2,
+                                                                 unsigned long long int *one, long long int words) {
+    //The inverse of m modulo 2^64, correct on 3 bits since m * m == 1 (mod 8).
+    unsigned long long int inverse = m[0];
+    //The odd part t of 64 * words.
+    long long int t = 64 * words;
+    //The exponent s of 2 in 64 * words.
+    long long int s = 0;
+
+    for (long long int i = 0; i < 5; ++i) {
+        inverse *= 2 - m[0] * inverse;
+    }
+    inverse = -inverse;
+
+    while (t % 2 == 0) {
+        t /= 2;
+        s++;
+    }
+
+    for (long long int i = 0; i < words; ++i) {
+        one[i] = 0;
+    }
+    one[0] = 1;
+    for (long long int i = 0; i < 64 * words; ++i) {
+        wordsSumModulo(one, one, one, m, words);
+    }
+    for (long long int i = 0; i < words; ++i) {
+        r2[i] = one[i];
+    }
+    for (long long int i = 0; i < t; ++i) {
+        wordsSumModulo(r2, r2, r2, m, words);
+    }
+    for (long long int i = 0; i < s; ++i) {
+        wordsMontgomeryProduct(r2, r2, r2, m, inverse, words);
+    }
+
+    return inverse;
+}
+
+/**
+ * Computes the power elevation in Montgomery form.
+ * @details fixed window of 4 bits: 15 products of precomputation, then 4 squares and one product per exponent digit.
+ *
+ * @param res the power in Montgomery form.
+ * @param a the base in Montgomery form.
+ * @param exp the exponent.
+ * @param m the odd module value.
+ * @param one the Montgomery form of 1.
+ * @param inverse -m^(-1) (mod 2^64).
+ * @param words the number of words.
+ */
+WORD_KERNEL void wordsMontgomeryPower(unsigned long long int *res, const unsigned long long int *a, const unsigned long long int *exp,
+                                      const unsigned long long int *m, const unsigned long long int *one,
+                                      unsigned long long int inverse, long long int words) {
+    //The powers a^0, ..., a^15 in Montgomery form.
+    unsigned long long int table[16][MAX_WORDS];
+    //The power.
+    unsigned long long int x[MAX_WORDS];
+
+    for (long long int i = 0; i < words; ++i) {
+        table[0][i] = one[i];
+        table[1][i] = a[i];
+        x[i] = one[i];
+    }
+    for (long long int k = 2; k < 16; ++k) {
+        wordsMontgomeryProduct(table[k], table[k - 1], a, m, inverse, words);
+    }
+
+    for (long long int i = 16 * words - 1; i >= 0; --i) {
+        //The exponent digit.
+        unsigned long long int digit = (exp[i / 16] >> (4 * (i % 16))) & 15;
+
+        for (long long int k = 0; k < 4; ++k) {
+            wordsMontgomeryProduct(x, x, x, m, inverse, words);
+        }
+        if (digit != 0) {
+            wordsMontgomeryProduct(x, x, table[digit], m, inverse, words);
+        }
+    }
+
+    for (long long int i = 0; i < words; ++i) {
+        res[i] = x[i];
+    }
+}
+
+/**
+ * Computes the modular inverse of a multi-word number.
+ * @details binary extended Euclidean algorithm: u = x1 * a and v = x2 * a (mod m) are kept while u and v are halved and subtracted,
+ * @details halving x modulo the odd m is x / 2 or (x + m) / 2, so no division is needed.
+ * @warning m must be odd, a must be coprime with m.
+ *
+ * @param res the inverse.
+ * @param a the number, lower than m.
+ * @param m the odd module value.
+ * @param words the number of words.
+ */
+WORD_KERNEL void wordsModularInverse(unsigned long long int *res, const unsigned long long int *a, const unsigned long long int *m,
+                                     long long int words) {
+    //The first remainder, x1 * a (mod m).
+    unsigned long long int u[MAX_WORDS];
+    //The second remainder, x2 * a (mod m).
+    unsigned long long int v[MAX_WORDS];
+    //The first coefficient.
+    unsigned long long int x1[MAX_WORDS] = {1};
+    //The second coefficient.
+    unsigned long long int x2[MAX_WORDS] = {0};
+
+    for (long long int i = 0; i < words; ++i) {
+        u[i] = a[i];
+        v[i] = m[i];
+    }
+    assert(!wordsIsZero(u, words) && "a must be coprime with m");
+
+    while (!(u[0] == 1 && wordsIsZero(u + 1, words - 1)) && !(v[0] == 1 && wordsIsZero(v + 1, words - 1))) {
+        while (u[0] % 2 == 0) {
+            wordsHalve(u, 0, words);
+            wordsHalve(x1, x1[0] % 2 ? wordsSum(x1, x1, m, words) : 0, words);
+        }
+        while (v[0] % 2 == 0) {
+            wordsHalve(v, 0, words);
+            wordsHalve(x2, x2[0] % 2 ? wordsSum(x2, x2, m, words) : 0, words);
+        }
+        if (wordsCompare(u, v, words) >= 0) {
+            wordsSub(u, u, v, words);
+            wordsSubModulo(x1, x1, x2, m, words);
+            assert(!wordsIsZero(u, words) && "a must be coprime with m");
+        } else {
+            wordsSub(v, v, u, words);
+            wordsSubModulo(x2, x2, x1, m, words);
+        }
+    }
+
+    for (long long int i = 0; i < words; ++i) {
+        res[i] = u[0] == 1 && wordsIsZero(u + 1, words - 1) ? x1[i] : x2[i];
+    }
+}
+
+/**
+ * Computes the remainder of a multi-word number divided by a word.
+ *
+ * @param a the number.
+ * @param d the divisor.
+ * @param words the number of words.
+ * @return a (mod d).
+ */
+WORD_KERNEL unsigned long long int wordsRemainder(const unsigned long long int *a, unsigned long long int d, long long int words) {
+    //The remainder.
+    unsigned __int128 r = 0;
+
+    for (long long int i = words - 1; i >= 0; --i) {
+        r = ((r << 64) | a[i]) % d;
+    }
+
+    return (unsigned long long int) r;
+}
+
+/**
+ * Checks if a multi-word number is a prime number with the Miller-Rabin test.
+ * @details trial division by the first 20 primes, then the strong probable prime test to the same 20 bases in Montgomery form.
+ * @details deterministic below 3.3 * 10^24 (the first 13 bases suffice), the error probability is at most 4^(-20) otherwise.
+ *
+ * @param n the number, greater than the trial divisors.
+ * @param words the number of words.
+ * @return 1 if the number is (probably) prime, 0 otherwise.
+ */
+WORD_KERNEL int wordsIsPrime(const unsigned long long int *n, long long int words) {
+    //The odd part of n - 1.
+    unsigned long long int d[MAX_WORDS];
+    //n - 1 in Montgomery form.
+    unsigned long long int minusOne[MAX_WORDS];
+    //The square of the Montgomery radix modulo n.
+    unsigned long long int r2[MAX_WORDS];
+    //The Montgomery form of 1.
+    unsigned long long int one[MAX_WORDS] = {0};
+    //The constant 1.
+    unsigned long long int unit[MAX_WORDS] = {1};
+    //-n^(-1) (mod 2^64).
+    unsigned long long int inverse = 0;
+    //The exponent of 2 in n - 1.
+    long long int s = 0;
+
+    for (long long int i = 0; i < MILLER_RABIN_BASES; ++i) {
+        if (wordsRemainder(n, SMALL_PRIMES[i], words) == 0) {
+            return wordsIsZero(n + 1, words - 1) && n[0] == SMALL_PRIMES[i];
+        }
+    }
+
+    wordsSub(d, n, unit, words);
+    while (d[0] % 2 == 0) {
+        wordsHalve(d, 0, words);
+        s++;
+    }
+    inverse = wordsMontgomeryPrecomputation(n, r2, one, words);
+    wordsSubModulo(minusOne, n, one, n, words);
+
+    for (long long int i = 0; i < MILLER_RABIN_BASES; ++i) {
+        //The base in Montgomery form, then the power a^(d * 2^r).
+        unsigned long long int x[MAX_WORDS] = {SMALL_PRIMES[i]};
+        //The number of squares taken.
+        long long int r = 1;
+
+        wordsMontgomeryProduct(x, x, r2, n, inverse, words);
+        wordsMontgomeryPower(x, x, d, n, one, inverse, words);
+        if (wordsCompare(x, one, words) == 0 || wordsCompare(x, minusOne, words) == 0) {
+            continue;
+        }
+        for (; r < s; ++r) {
+            wordsMontgomeryProduct(x, x, x, n, inverse, words);
+            if (wordsCompare(x, minusOne, words) == 0) {
+                break;
+            }
+        }
+        //a is a witness of compositeness
+        if (r == s) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Computes a square root modulo p of a multi-word number.
+ * @details Tonelli-Shanks algorithm in Montgomery form: p - 1 = q * 2^s, the root starts at a^((q+1)/2),
+ * @details and the error t = a^q is pushed into smaller subgroups of order 2^i with powers of a non-residue z^q.
+ * @warning p must be an odd prime number, it is not tested.
+ *
+ * @param res a square root, the other one is p - res.
+ * @param a the number, lower than p.
+ * @param p the odd prime.
+ * @param words the number of words.
+ * @return 1 if a is a quadratic residue modulo p, 0 otherwise.
+ */
+WORD_KERNEL int wordsSquareRoot(unsigned long long int *res, const unsigned long long int *a, const unsigned long long int *p,
+                                long long int words) {
+    //The constant 1.
+    unsigned long long int unit[MAX_WORDS] = {1};
+    //(p - 1) / 2, then the odd part q of p - 1.
+    unsigned long long int q[MAX_WORDS];
+    //The square of the Montgomery radix modulo p.
+    unsigned long long int r2[MAX_WORDS];
+    //The Montgomery form of 1.
+    unsigned long long int one[MAX_WORDS] = {0};
+    //p - 1 in Montgomery form.
+    unsigned long long int minusOne[MAX_WORDS];
+    //The number in Montgomery form.
+    unsigned long long int x[MAX_WORDS];
+    //The Euler criterion, then the error t = a^q.
+    unsigned long long int t[MAX_WORDS];
+    //The non-residue, then c = z^(q * 2^(s - i)).
+    unsigned long long int c[MAX_WORDS] = {1};
+    //The root.
+    unsigned long long int r[MAX_WORDS];
+    //The exponent (q + 1) / 2.
+    unsigned long long int half[MAX_WORDS];
+    //-p^(-1) (mod 2^64).
+    unsigned long long int inverse = wordsMontgomeryPrecomputation(p, r2, one, words);
+    //The exponent of 2 in p - 1.
+    long long int s = 1;
+
+    if (wordsIsZero(a, words)) {
+        for (long long int i = 0; i < words; ++i) {
+            res[i] = 0;
+        }
+        return 1;
+    }
+
+    wordsSub(q, p, unit, words);
+    wordsHalve(q, 0, words);
+    wordsSubModulo(minusOne, p, one, p, words);
+    wordsMontgomeryProduct(x, a, r2, p, inverse, words);
+
+    //Euler's criterion: a^((p-1)/2) == 1
+    wordsMontgomeryPower(t, x, q, p, one, inverse, words);
+    if (wordsCompare(t, one, words) != 0) {
+        return 0;
+    }
+
+    while (q[0] % 2 == 0) {
+        wordsHalve(q, 0, words);
+        s++;
+    }
+    //the first non-residue z, z^((p-1)/2) == -1
+    do {
+        //(p - 1) / 2.
+        unsigned long long int e[MAX_WORDS];
+
+        c[0]++;
+        wordsSub(e, p, unit, words);
+        wordsHalve(e, 0, words);
+        wordsMontgomeryProduct(t, c, r2, p, inverse, words);
+        wordsMontgomeryPower(t, t, e, p, one, inverse, words);
+    } while (wordsCompare(t, minusOne, words) != 0);
+    wordsMontgomeryProduct(c, c, r2, p, inverse, words);
+    wordsMontgomeryPower(c, c, q, p, one, inverse, words);
+
+    wordsSum(half, q, unit, words);
+    wordsHalve(half, 0, words);
+    wordsMontgomeryPower(r, x, half, p, one, inverse, words);
+    wordsMontgomeryPower(t, x, q, p, one, inverse, words);
+
+    while (wordsCompare(t, one, words) != 0) {
+        //The order 2^i of t.
+        long long int i = 0;
+        //The powers t^(2^i).
+        unsigned long long int y[MAX_WORDS];
+
+        for (long long int j = 0; j < words; ++j) {
+            y[j] = t[j];
+        }
+        while (wordsCompare(y, one, words) != 0) {
+            wordsMontgomeryProduct(y, y, y, p, inverse, words);
+            i++;
+        }
+        //c = c^(2^(s - i - 1)), then r = r * c, c = c^2, t = t * c
+        for (long long int j = 0; j < s - i - 1; ++j) {
+            wordsMontgomeryProduct(c, c, c, p, inverse, words);
+        }
+        wordsMontgomeryProduct(r, r, c, p, inverse, words);
+        wordsMontgomeryProduct(c, c, c, p, inverse, words);
+        wordsMontgomeryProduct(t, t, c, p, inverse, words);
+        s = i;
+    }
+
+    wordsMontgomeryProduct(res, r, unit, p, inverse, words);
+    return 1;
+}
+
+/**
+ * Converts a multi-word number to hexadecimal digits.
+ *
+ * @param a the number.
+ * @param res the 16 * words hexadecimal digits, most significant first, and the terminator.
+ * @param words the number of words.
+ */
+WORD_KERNEL void wordsToHex(const unsigned long long int *a, char *res, long long int words) {
+    //The hexadecimal digits.
+    const char *digits = "0123456789abcdef";
+
+    for (long long int i = 0; i < 16 * words; ++i) {
+        //The position of the digit, from the least significant.
+        long long int k = 16 * words - 1 - i;
+
+        res[i] = digits[(a[k / 16] >> (4 * (k % 16))) & 15];
+    }
+    res[16 * words] = '\0';
+}
+
+/**
+ * Converts hexadecimal digits to a multi-word number.
+ * @details an optional 0x prefix is skipped, the digits beyond the width are shifted out.
+ *
+ * @param res the number.
+ * @param hex the hexadecimal digits, most significant first.
+ * @param words the number of words.
+ */
+WORD_KERNEL void wordsFromHex(unsigned long long int *res, const char *hex, long long int words) {
+    for (long long int i = 0; i < words; ++i) {
+        res[i] = 0;
+    }
+    if (hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+        hex += 2;
+    }
+
+    for (; *hex != '\0'; ++hex) {
+        //The value of the digit.
+        unsigned long long int digit = *hex >= '0' && *hex <= '9' ? (unsigned long long int) (*hex - '0') :
+                                       *hex >= 'a' && *hex <= 'f' ? (unsigned long long int) (*hex - 'a' + 10) :
+                                       (unsigned long long int) (*hex - 'A' + 10);
+        assert(digit < 16 && "not a hexadecimal digit");
+
+        for (long long int i = words - 1; i > 0; --i) {
+            res[i] = (res[i] << 4) | (res[i - 1] >> 60);
+        }
+        res[0] = (res[0] << 4) | digit;
+    }
+}
+
+
+/**
+ * Defines the multi-word arithmetic of a width, see MULTI_WORD_DECLARATIONS.
+ * @details every function is a thin wrapper of a word kernel with a constant number of words.
+ *
+ * @param BITS the width, 128, 256 or 512.
+ */
+#define MULTI_WORD_DEFINITIONS(BITS)                                                                                     \
+    u##BITS u##BITS##FromInteger(unsigned long long int n) {                                                             \
+        u##BITS res = {{n}};                                                                                             \
+        return res;                                                                                                      \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS u##BITS##FromHex(const char *hex) {                                                                          \
+        u##BITS res;                                                                                                     \
+        wordsFromHex(res.word, hex, BITS / 64);                                                                          \
+        return res;                                                                                                      \
+    }                                                                                                                    \
+                                                                                                                         \
+    void u##BITS##ToHex(u##BITS a, char *res) {                                                                          \
+        wordsToHex(a.word, res, BITS / 64);                                                                              \
+    }                                                                                                                    \
+                                                                                                                         \
+    int u##BITS##Compare(u##BITS a, u##BITS b) {                                                                         \
+        return wordsCompare(a.word, b.word, BITS / 64);                                                                  \
+    }                                                                                                                    \
+                                                                                                                         \
+    montgomery##BITS *createMontgomery##BITS(u##BITS m) {                                                                \
+        assert(m.word[0] % 2 == 1 && !(m.word[0] == 1 && wordsIsZero(m.word + 1, BITS / 64 - 1)) &&                      \
+               "m must be odd and greater than 1");                                                                      \
+                                                                                                                         \
+        montgomery##BITS *context = malloc(sizeof(montgomery##BITS));                                                    \
+        assert(context != NULL);                                                                                         \
+                                                                                                                         \
+        context->m = m;                                                                                                  \
+        context->inverse = wordsMontgomeryPrecomputation(m.word, context->r2.word, context->one.word, BITS / 64);        \
+        return context;                                                                                                  \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS toMontgomery##BITS(montgomery##BITS *context, u##BITS a) {                                                   \
+        wordsMontgomeryProduct(a.word, a.word, context->r2.word, context->m.word, context->inverse, BITS / 64);          \
+        return a;                                                                                                        \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS fromMontgomery##BITS(montgomery##BITS *context, u##BITS a) {                                                 \
+        u##BITS unit = {{1}};                                                                                            \
+        wordsMontgomeryProduct(a.word, a.word, unit.word, context->m.word, context->inverse, BITS / 64);                 \
+        return a;                                                                                                        \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS montgomeryProduct##BITS(montgomery##BITS *context, u##BITS a, u##BITS b) {                                   \
+        wordsMontgomeryProduct(a.word, a.word, b.word, context->m.word, context->inverse, BITS / 64);                    \
+        return a;                                                                                                        \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS montgomeryPower##BITS(montgomery##BITS *context, u##BITS a, u##BITS exp) {                                   \
+        wordsMontgomeryPower(a.word, a.word, exp.word, context->m.word, context->one.word, context->inverse, BITS / 64); \
+        return a;                                                                                                        \
+    }                                                                                                                    \
+                                                                                                                         \
+    void deleteMontgomery##BITS(montgomery##BITS *context) {                                                             \
+        free(context);                                                                                                   \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS sum##BITS(u##BITS a, u##BITS b, u##BITS m) {                                                                 \
+        wordsSumModulo(a.word, a.word, b.word, m.word, BITS / 64);                                                       \
+        return a;                                                                                                        \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS sub##BITS(u##BITS a, u##BITS b, u##BITS m) {                                                                 \
+        wordsSubModulo(a.word, a.word, b.word, m.word, BITS / 64);                                                       \
+        return a;                                                                                                        \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS product##BITS##FromContext(montgomery##BITS *context, u##BITS a, u##BITS b) {                                \
+        /* a * R * b * R^-1 = a * b */                                                                                   \
+        return montgomeryProduct##BITS(context, toMontgomery##BITS(context, a), b);                                      \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS power##BITS##FromContext(montgomery##BITS *context, u##BITS a, u##BITS exp) {                                \
+        return fromMontgomery##BITS(context, montgomeryPower##BITS(context, toMontgomery##BITS(context, a), exp));       \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS product##BITS(u##BITS a, u##BITS b, u##BITS m) {                                                             \
+        assert(m.word[0] % 2 == 1 && "m must be odd");                                                                   \
+                                                                                                                         \
+        montgomery##BITS context;                                                                                        \
+        context.m = m;                                                                                                   \
+        context.inverse = wordsMontgomeryPrecomputation(m.word, context.r2.word, context.one.word, BITS / 64);           \
+                                                                                                                         \
+        return product##BITS##FromContext(&context, a, b);                                                               \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS power##BITS(u##BITS a, u##BITS exp, u##BITS m) {                                                             \
+        assert(m.word[0] % 2 == 1 && "m must be odd");                                                                   \
+                                                                                                                         \
+        montgomery##BITS context;                                                                                        \
+        context.m = m;                                                                                                   \
+        context.inverse = wordsMontgomeryPrecomputation(m.word, context.r2.word, context.one.word, BITS / 64);           \
+                                                                                                                         \
+        return power##BITS##FromContext(&context, a, exp);                                                               \
+    }                                                                                                                    \
+                                                                                                                         \
+    u##BITS modularInverse##BITS(u##BITS a, u##BITS m) {                                                                 \
+        assert(m.word[0] % 2 == 1 && "m must be odd");                                                                   \
+        assert(wordsCompare(a.word, m.word, BITS / 64) < 0 && "a must be reduced modulo m");                             \
+                                                                                                                         \
+        u##BITS res;                                                                                                     \
+        wordsModularInverse(res.word, a.word, m.word, BITS / 64);                                                        \
+        return res;                                                                                                      \
+    }                                                                                                                    \
+                                                                                                                         \
+    int isPrime##BITS(u##BITS n) {                                                                                       \
+        /* the words below 2^63 go to the deterministic 64-bit test */                                                   \
+        if (wordsIsZero(n.word + 1, BITS / 64 - 1) && n.word[0] < (1ULL << 63)) {                                        \
+            return (int) MillerRabinTest((long long int) n.word[0]);                                                     \
+        }                                                                                                                \
+                                                                                                                         \
+        return wordsIsPrime(n.word, BITS / 64);                                                                          \
+    }                                                                                                                    \
+                                                                                                                         \
+    int squareRoot##BITS(u##BITS a, u##BITS p, u##BITS *res) {                                                           \
+        assert(p.word[0] % 2 == 1 && !(p.word[0] == 1 && wordsIsZero(p.word + 1, BITS / 64 - 1)) &&                      \
+               "p must be an odd prime");                                                                                \
+        assert(wordsCompare(a.word, p.word, BITS / 64) < 0 && "a must be reduced modulo p");                             \
+                                                                                                                         \
+        return wordsSquareRoot(res->word, a.word, p.word, BITS / 64);                                                    \
+    }
+
+MULTI_WORD_DEFINITIONS(128)
+MULTI_WORD_DEFINITIONS(256)
+MULTI_WORD_DEFINITIONS(512)
@@ -1,6 +1,5 @@
 #include <assert.h>
 #include <malloc.h>
-#include <math.h>
 
 #include "../ModularArithmetic.h"
 
@@ -8,6 +7,7 @@
 /**
  * Computes the sum modulo m.
  * @details res = a + b (mod m).
+ * @details a + b is never formed when it would exceed m, so it does not overflow for any m.
  *
  * @param a the first addend.
  * @param b the second addend.
@@ -18,7 +18,7 @@ long long int sum(long long int a, long long int b, long long int m) {
     a = a < 0 ? modularReduction(mod(a, m), m) : mod(a, m);
     b = b < 0 ? modularReduction(mod(b, m), m) : mod(b, m);
 
-    return (a + b) % m;
+    return a >= m - b ? a - (m - b) : a + b;
 }
 
 /**
@@ -39,9 +39,29 @@ long long int sub(long long int a, long long int b, long long int m) {
     return sum(a, b, m);
 }
 
+/**
+ * Computes the product modulo m of two reduced numbers.
+ * @details the product fits in 64 bits below 2^32, it is computed on 128 bits otherwise.
+ * @warning a and b must be in [0, m).
+ *
+ * @param a the first factor.
+ * @param b the second factor.
+ * @param m the module value.
+ * @return the product modulo m.
+ */
+static long long int reducedProduct(long long int a, long long int b, long long int m) {
+    if (m <= 0xFFFFFFFFLL) {
+        return (long long int) ((unsigned long long int) a * (unsigned long long int) b % (unsigned long long int) m);
+    }
+
+    return (long long int) ((unsigned __int128) a * (unsigned long long int) b % (unsigned long long int) m);
+}
+
+
 /**
  * Computes the product modulo m.
  * @details res = a * b (mod m).
+ * @details the product is computed on 128 bits, so it does not overflow for any m.
  *
  * @param a the first factor.
  * @param b the second factor.
@@ -52,7 +72,7 @@ long long int product(long long int a, long long int b, long long int m) {
     a = a < 0 ? modularReduction(mod(a, m), m) : mod(a, m);
     b = b < 0 ? modularReduction(mod(b, m), m) : mod(b, m);
 
-    return a * b % m;
+    return (long long int) ((__int128) a * b % m);
 }
 
 /**
@@ -100,14 +120,14 @@ long long int power(long long int a, long long int exp, long long int m) {
     while (exp > 0) {
         //if exp bit is 1, multiplies the result by the base
         if (exp % 2 == 1) {
-            res = product(res, a, m);
+            res = reducedProduct(res, a, m);
         }
 
         //shifted to the next bit
         exp >>= 1;
 
         //square of the base
-        a = product(a, a, m);
+        a = reducedProduct(a, a, m);
     }
 
     return res;
@@ -117,113 +137,36 @@ long long int power(long long int a, long long int exp, long long int m) {
  * Computes the square roots modulo p of a number.
  * @details Tonelli-Shanks algorithm
  * @details two different result (+res && -res)
- * @warning p must be a prime number.
+ * @warning p must be an odd prime number, it is not tested.
  *
  * @param a the number whose square root is to be calculated.
  * @param p the module value.
- * @return the square roots modulo p of the number.
+ * @return the square roots modulo p of the number, NULL if a is not a quadratic residue modulo p.
  */
 long long int *TonelliShanksAlgorithm(long long int a, long long int p) {
     assert(p != 2);
-    assert(isPrime(p));
 
-    //The number of factors.
-    long long int factorSize = 0;
-    //The list of factors of n-1.
-    long long int *factor = factorisation(p - 1, &factorSize);
-    assert(factor[0] == 2 || factor[1] == 2);
-    //The module value.
-    long long int nTmp = p;
-    //The q number st n-1 = q*2^s.
-    long long int q = 0;
-    //The s number st n-1 = q*2^s.
-    long long int s = 0;
-    //The non-residual quadratic.
-    long long int z = 0;
-    //The c number st initialize as z^q and is updated as b^2.
-    long long int c = 0;
-    //The r number st initialize as a^((q+1)/2) and is updated as r*b.
-    long long int r = 0;
-    //The t number st initialize as a^q and is updated as t*b^2.
-    long long int t = 0;
-    //The m number st initialize as s and is updated as i.
-    long long int m = 0;
-    //t^(2^i) (mod n).
-    long long int t2i = 0;
-    //The smallest i st t^(2^i) == 1 (mod n).
-    long long int i = 0;
-    //The b number.
-    long long int b = 0;
+    //The square-root precomputation - q, s and the non-residue.
+    squareRootContext *context = createSquareRootContext(p);
+    //The square root.
+    long long int r = squareRootFromContext(context, a);
 
-    //define q & s
-    for (long long int j = 0; j < factorSize; ++j) {
-        if (factor[j] != 2) {
-            q = factor[j];
-        }
-        else {
-            nTmp -= 1;
-            while (nTmp % 2 == 0) {
-                s++;
-                nTmp /= 2;
-            }
-        }
+    deleteSquareRootContext(context);
+    if (r == -1) {
+        return NULL;
     }
 
-    //find a non-residual quadratic number
-    for (long long int j = 2; j < p; ++j) {
-        if (LegendreSymbol(j, p) == -1) {
-            z = j;
-            break;
-        }
-    }
-
-    //initial value
-    c = power(z, q, p); //c = z^q (mod n)
-    r = power(a, (q + 1) / 2, p); //r = a^((q+1)/2) (mod n)
-    t = power(a, q, p); //t = a^q (mod n)
-    m = s;
-
-    //find the square root
-    while (1) {
-        if (t == 0) {
-            free(factor);
-
-            //The 2 square roots.
-            long long int *res = malloc(2 * sizeof(long long int));
-            res[0] = 0;
-            res[1] = 0;
-            return res;
-        }
-        if (t == 1) {
-            free(factor);
-
-            //The 2 square roots.
-            long long int *res = malloc(2 * sizeof(long long int));
-            res[0] = r;
-            res[1] = modularReduction(-r, p);
-            return res;
-        }
-
-        //find the smallest i st t^(2^i) == 1 (mod n).
-        t2i = t;
-        for (i = 0; i < m; ++i) {
-            t2i = power(t, pow(2, i), p);
-            if (t2i == 1) {
-                break;
-            }
-        }
-
-        //update the variable
-        b = power(c, (1 << (m - i - 1)), p); //b = c^(2^(m-i-1)) (mod n)
-        r = product(r, b, p); //r = r*b (mod n)
-        t = product(t, power(b, 2, p), p); //t = t*b^2 (mod n)
-        c = power(b, 2, p); //c = b^2 (mod n)
-        m = i;
-    }
+    //The 2 square roots.
+    long long int *res = malloc(2 * sizeof(long long int));
+    res[0] = r;
+    res[1] = modularReduction(-r, p);
+    return res;
 }
 
 /**
  * Computes the square roots modulo m of a number.
+ * @details factorisation of m, Hensel lifting modulo every prime power and Chinese Reminder Theorem - see allSquareRoots.
+ * @details the square roots are sorted.
  * @warning a must be a quadratic residue modulo m.
  *
  * @param a the number whose square root is to be calculated.
@@ -232,182 +175,35 @@ long long int *TonelliShanksAlgorithm(long long int a, long long int p) {
  * @return the square roots modulo m of the number.
  */
 long long int *squareRoot(long long int a, long long int m, long long int *numberOfSquareRoots) {
-    assert(isSquareNumber(a, m) && "a must be a quadratic residue modulo m");
+    *numberOfSquareRoots = allSquareRoots(a, m, NULL, 0);
+    assert(*numberOfSquareRoots > 0 && "a must be a quadratic residue modulo m");
 
-    //m is prime
-    if (isPrime(m)) {
-        //m == 1 (mod 4)
-        if (areCongruent(m, 1, 4)) {
-            *numberOfSquareRoots = 2;
-            return TonelliShanksAlgorithm(a, m);
-        }
-
-        //m == 3 (mod 4)
-        if (areCongruent(m, 3, 4)) {
-            //The root square.
-            long long int r = power(a, (long long int) ((m + 1) / 4), m);
-            //The 2 square roots.
-            long long int *res = malloc(2 * sizeof(long long int));
-            res[0] = r;
-            res[1] = modularReduction(-r, m);
-
-            *numberOfSquareRoots = 2;
-            return res;
-        }
-
-        //m == 5 (mod 8)
-        if (areCongruent(m, 5, 8)) {
-            //The d value.
-            long long int d = power(a, ((m - 1) / 4), m);
-
-            if (d == 1) {
-                //The root square.
-                long long int r = power(a, ((m + 3) / 8), m);
-                //The 2 square roots.
-                long long int *res = malloc(2 * sizeof(long long int));
-                res[0] = r;
-                res[1] = modularReduction(-r, m);
-
-                *numberOfSquareRoots = 2;
-                return res;
-            }
-            if (d == (m - 1)) {
-                //The root square.
-                long long int r = power((4 * a), ((m - 5) / 8), m);
-                r = product((2 * a), r, m);
-                //The 2 square roots.
-                long long int *res = malloc(2 * sizeof(long long int));
-                res[0] = r;
-                res[1] = modularReduction(-r, m);
-
-                *numberOfSquareRoots = 2;
-                return res;
-            }
-
-            //this case cannot happen
-            return NULL;
-        }
-    }
-
-    //m is NOT prime
-
-    //The number of factors.
-    long long int factorSize = 0;
-    //The factors that make up the number.
-    long long int *factor = factorisation(m, &factorSize);
-
-    //m = p*q
-    if (factorSize == 2 && (factor[0] * factor[1]) == m) {
-        //The number of square roots.
-        long long int squareRootPSize = 0;
-        //The square roots of a (mod p).
-        long long int *squareRootP = squareRoot(a, factor[0], &squareRootPSize);
-        //The number of square roots.
-        long long int squareRootQSize = 0;
-        //The square roots of a (mod p).
-        long long int *squareRootQ = squareRoot(a, factor[1], &squareRootQSize);
-        //The c value - p*c + q*d = 1.
-        long long int c = 0;
-        //The d value - p*c + q*d = 1.
-        long long int d = 0;
-        //The first root square.
-        long long int x = 0;
-        //The second root square.
-        long long int y = 0;
-        //The 4 square roots.
-        long long int *res = malloc(4 * sizeof(long long int));
-
-        //find c & d
-        diophantineEquation(factor[0], &c, factor[1], &d, 1);
-
-        //compute the root square
-        //r*d*q
-        d = product(squareRootP[0], d, m);
-        d = product(d, factor[1], m);
-        //s*c*p
-        c = product(squareRootQ[0], c, m);
-        c = product(c, factor[0], m);
-        //x = rdq + scp
-        x = sum(d, c, m);
-        //y = rdq - scp
-        y = sub(d, c, m);
-
-        //save all solution
-        res[0] = x;
-        res[1] = modularReduction(-x, m);
-        res[2] = y;
-        res[3] = modularReduction(-y, m);
-
-        *numberOfSquareRoots = 4;
-        free(factor);
-        free(squareRootP);
-        free(squareRootQ);
-        return res;
-    }
-
-    //m has more than 2 factors
-
-    //The number of square roots.
-    long long int resultSize = 0;
     //The square roots.
-    long long int *result = calloc(2, sizeof(long long int));
-
-    for (long long int i = 0; i < m; ++i) {
-        if (power(i, 2, m) == a) {
-            result[resultSize++] = i;
-            result[resultSize++] = modularReduction(-i, m);
-            result = realloc(result, (resultSize + 2) * sizeof(long long int));
-        }
-    }
+    long long int *res = malloc(*numberOfSquareRoots * sizeof(long long int));
+    allSquareRoots(a, m, res, *numberOfSquareRoots);
 
-    free(factor);
-    result = realloc(result, resultSize);
-    return result;
+    return res;
 }
 
 /**
  * Computes the discrete logarithm modulo m of base number.
  * @details Baby-Step Giant-Step algorithm.
+ * @details the baby steps are stored in a hash table, so the algorithm takes O(sqrt(m)) time and memory.
  * @details b = base^x (mod m) where x = Log_(base) (b).
- * @warning base must be base primitive root modulo m.
+ * @warning base should be a primitive root modulo m, otherwise the logarithm may not exist.
  *
  * @param base the logarithm base.
  * @param b the number.
  * @param m the module value.
- * @return the discrete logarithm modulo m.
+ * @return the discrete logarithm modulo m, -1 if it does not exist.
  */
 long long int discreteLogarithm(long long int base, long long int b, long long int m) {
-    assert(isPrimitiveRoot(base, m));
+    //The baby steps - base^j (mod m) 0<=j<sqrt(m), keyed by residue.
+    discreteLogarithmTable *table = createDiscreteLogarithmTable(base, m, m, 0);
+    //The discrete logarithm.
+    long long int res = discreteLogarithmFromTable(table, b);
 
-    //The square root of m rounded up.
-    long long int N = ceil(sqrt(m));
-    //The first component to check - base^j (mod m) 0<=j<N.
-    long long int *aj = malloc(N * sizeof(long long int));
-    //The value of base^(-N) (mod m).
-    long long int aN = 0;
-    //The second component to check - b*base^(-Nk) (mod m) 0<=k<N.
-    long long int baNk = b;
-    //The position in the first component.
-    long long int ajPos = 0;
-
-    //compute the first component
-    for (long long int i = 0; i < N; ++i) {
-        aj[i] = power(base, i, m);
-    }
-
-    //base^(-N) (mod m)
-    aN = modularInverse(base, m);
-    aN = power(aN, N, m);
-
-    for (long long int i = 0; i < N; ++i) {
-        if (isListed(aj, N, baNk, &ajPos)) {
-            free(aj);
-            return ajPos + N * i;
-        }
-        baNk = product(baNk, aN, m);
-    }
-
-    free(aj);
-    //this case cannot happen because base is base primitive root modulo m
-    return -1;
-}
\ No newline at end of file
+    deleteDiscreteLogarithmTable(table);
+    //-1 if base is not a primitive root modulo m and b is not one of its powers
+    return res;
+}
@@ -0,0 +1,930 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * The shortest operand from which the products and the divisions use the transforms, below it the schoolbook ones are faster.
+ */
+#define SCHOOLBOOK_THRESHOLD 64
+
+/**
+ * The largest number of points of a leaf of the subproduct tree, evaluated with Horner's rule.
+ */
+#define TREE_LEAF 64
+
+
+/**
+ * Computes the product of two coefficients modulo p.
+ *
+ * @param a the first coefficient, lower than p.
+ * @param b the second coefficient, lower than p.
+ * @param p the prime.
+ * @return the product modulo p.
+ */
+static unsigned long long int coefficientProduct(unsigned long long int a, unsigned long long int b, unsigned long long int p) {
+    return (unsigned long long int) ((unsigned __int128) a * b % p);
+}
+
+/**
+ * Computes the sum of two coefficients modulo p.
+ * @details a + b may wrap around 2^64 when p is above 2^63, the wrap means it is above p.
+ *
+ * @param a the first coefficient, lower than p.
+ * @param b the second coefficient, lower than p.
+ * @param p the prime.
+ * @return the sum modulo p.
+ */
+static unsigned long long int coefficientSum(unsigned long long int a, unsigned long long int b, unsigned long long int p) {
+    //The sum, modulo 2^64.
+    unsigned long long int s = a + b;
+
+    return s < a || s >= p ? s - p : s;
+}
+
+/**
+ * Computes the difference of two coefficients modulo p.
+ *
+ * @param a the minuend, lower than p.
+ * @param b the subtrahend, lower than p.
+ * @param p the prime.
+ * @return the difference modulo p.
+ */
+static unsigned long long int coefficientSub(unsigned long long int a, unsigned long long int b, unsigned long long int p) {
+    return a >= b ? a - b : a - b + p;
+}
+
+/**
+ * Computes the inverse of a coefficient modulo p.
+ * @details Fermat's little theorem: a^(-1) = a^(p-2) (mod p).
+ *
+ * @param a the coefficient, lower than p and not 0.
+ * @param p the prime.
+ * @return the inverse modulo p.
+ */
+static unsigned long long int coefficientInverse(unsigned long long int a, unsigned long long int p) {
+    //The result.
+    unsigned long long int res = 1;
+    //The exponent.
+    unsigned long long int exp = p - 2;
+
+    while (exp > 0) {
+        if (exp % 2 == 1) {
+            res = coefficientProduct(res, a, p);
+        }
+        exp >>= 1;
+        a = coefficientProduct(a, a, p);
+    }
+
+    return res;
+}
+
+/**
+ * Creates a polynomial with zero coefficients.
+ *
+ * @param size the number of coefficients.
+ * @return the polynomial.
+ */
+static polynomial *zeroPolynomial(long long int size) {
+    //The polynomial.
+    polynomial *res = malloc(sizeof(polynomial));
+    assert(res != NULL);
+
+    res->size = size;
+    res->coefficient = calloc(size > 0 ? size : 1, sizeof(unsigned long long int));
+    assert(res->coefficient != NULL);
+
+    return res;
+}
+
+/**
+ * Removes the leading zero coefficients of a polynomial.
+ *
+ * @param a the polynomial, trimmed in place.
+ * @return the polynomial.
+ */
+static polynomial *trimPolynomial(polynomial *a) {
+    while (a->size > 0 && a->coefficient[a->size - 1] == 0) {
+        a->size--;
+    }
+
+    return a;
+}
+
+/**
+ * Creates the polynomial made of a range of coefficients of another one.
+ * @details from = k and to = size is the division by x^k, from = 0 and to = k the reduction modulo x^k.
+ *
+ * @param a the polynomial.
+ * @param from the first coefficient, included.
+ * @param to the last coefficient, excluded, it may exceed the size.
+ * @return the polynomial sum(a_(from + i) * x^i).
+ */
+static polynomial *slicePolynomial(polynomial *a, long long int from, long long int to) {
+    //The polynomial.
+    polynomial *res = zeroPolynomial((to < a->size ? to : a->size) - from > 0 ? (to < a->size ? to : a->size) - from : 0);
+
+    for (long long int i = 0; i < res->size; ++i) {
+        res->coefficient[i] = a->coefficient[from + i];
+    }
+
+    return trimPolynomial(res);
+}
+
+/**
+ * Creates the reversed polynomial x^(size-1) * a(1/x).
+ *
+ * @param a the polynomial, with at most size coefficients.
+ * @param size the number of coefficients of the reversal.
+ * @return the reversed polynomial.
+ */
+static polynomial *reversePolynomial(polynomial *a, long long int size) {
+    //The polynomial.
+    polynomial *res = zeroPolynomial(size);
+
+    for (long long int i = 0; i < a->size; ++i) {
+        res->coefficient[size - 1 - i] = a->coefficient[i];
+    }
+
+    return trimPolynomial(res);
+}
+
+/**
+ * Computes the product of two polynomials modulo x^n.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the first polynomial.
+ * @param b the second polynomial.
+ * @param n the number of coefficients kept.
+ * @return the product modulo x^n.
+ */
+static polynomial *truncatedProduct(nttContext *context, polynomial *a, polynomial *b, long long int n) {
+    //The first polynomial modulo x^n.
+    polynomial *ta = slicePolynomial(a, 0, n);
+    //The second polynomial modulo x^n.
+    polynomial *tb = slicePolynomial(b, 0, n);
+    //The product.
+    polynomial *res = polynomialProduct(context, ta, tb);
+
+    res->size = res->size < n ? res->size : n;
+    deletePolynomial(ta);
+    deletePolynomial(tb);
+
+    return trimPolynomial(res);
+}
+
+
+/**
+ * Computes the division with remainder of two polynomials with the inverse of the reversed divisor.
+ * @details rev(q) = rev(a) * rev(b)^(-1) (mod x^k) with k = deg(a) - deg(b) + 1, then r = a - q * b: two products.
+ * @warning deg(a) must not be lower than deg(b), the inverse must be known modulo x^k at least.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the dividend.
+ * @param b the divisor.
+ * @param inverse rev(b)^(-1) modulo x^k or a higher power.
+ * @param quotient the quotient.
+ * @param remainder the remainder.
+ */
+static void reversedDivision(nttContext *context, polynomial *a, polynomial *b, polynomial *inverse, polynomial **quotient,
+                             polynomial **remainder) {
+    //The number of coefficients of the quotient.
+    long long int k = a->size - b->size + 1;
+    //The reversed dividend.
+    polynomial *ra = reversePolynomial(a, a->size);
+    //The reversed quotient.
+    polynomial *rq = truncatedProduct(context, ra, inverse, k);
+    //q * b.
+    polynomial *qb = NULL;
+
+    *quotient = reversePolynomial(rq, k);
+    qb = polynomialProduct(context, *quotient, b);
+    *remainder = polynomialSub(context, a, qb);
+
+    deletePolynomial(ra);
+    deletePolynomial(rq);
+    deletePolynomial(qb);
+}
+
+
+/**
+ * Creates a polynomial modulo a prime.
+ *
+ * @param size the number of coefficients.
+ * @param coefficient the coefficients, lowest degree first, lower than p; they are copied.
+ * @return the polynomial, without leading zero coefficients.
+ */
+polynomial *createPolynomial(long long int size, unsigned long long int *coefficient) {
+    assert(size >= 0);
+
+    //The polynomial.
+    polynomial *res = zeroPolynomial(size);
+
+    for (long long int i = 0; i < size; ++i) {
+        res->coefficient[i] = coefficient[i];
+    }
+
+    return trimPolynomial(res);
+}
+
+/**
+ * Computes the sum of two polynomials modulo a prime.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the first polynomial.
+ * @param b the second polynomial.
+ * @return the sum.
+ */
+polynomial *polynomialSum(nttContext *context, polynomial *a, polynomial *b) {
+    //The sum.
+    polynomial *res = zeroPolynomial(a->size > b->size ? a->size : b->size);
+
+    for (long long int i = 0; i < res->size; ++i) {
+        res->coefficient[i] = coefficientSum(i < a->size ? a->coefficient[i] : 0, i < b->size ? b->coefficient[i] : 0, context->p);
+    }
+
+    return trimPolynomial(res);
+}
+
+/**
+ * Computes the difference of two polynomials modulo a prime.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the minuend.
+ * @param b the subtrahend.
+ * @return the difference.
+ */
+polynomial *polynomialSub(nttContext *context, polynomial *a, polynomial *b) {
+    //The difference.
+    polynomial *res = zeroPolynomial(a->size > b->size ? a->size : b->size);
+
+    for (long long int i = 0; i < res->size; ++i) {
+        res->coefficient[i] = coefficientSub(i < a->size ? a->coefficient[i] : 0, i < b->size ? b->coefficient[i] : 0, context->p);
+    }
+
+    return trimPolynomial(res);
+}
+
+/**
+ * Computes the product of two polynomials modulo a prime.
+ * @details the convolution of the coefficients with the transforms, O(n log n), or schoolbook for short polynomials.
+ * @warning the number of coefficients of the product must not be greater than the maxLength of the context.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the first polynomial.
+ * @param b the second polynomial.
+ * @return the product.
+ */
+polynomial *polynomialProduct(nttContext *context, polynomial *a, polynomial *b) {
+    if (a->size == 0 || b->size == 0) {
+        return zeroPolynomial(0);
+    }
+
+    //The product.
+    polynomial *res = zeroPolynomial(a->size + b->size - 1);
+
+    if (a->size < SCHOOLBOOK_THRESHOLD || b->size < SCHOOLBOOK_THRESHOLD) {
+        for (long long int i = 0; i < a->size; ++i) {
+            for (long long int j = 0; j < b->size; ++j) {
+                res->coefficient[i + j] = coefficientSum(res->coefficient[i + j],
+                                                         coefficientProduct(a->coefficient[i], b->coefficient[j], context->p),
+                                                         context->p);
+            }
+        }
+    } else {
+        nttConvolution(context, a->coefficient, a->size, b->coefficient, b->size, res->coefficient);
+    }
+
+    return trimPolynomial(res);
+}
+
+/**
+ * Computes the inverse of a polynomial modulo x^n.
+ * @details Newton's iteration: g_(2k) = g_k * (2 - a * g_k) (mod x^(2k)) doubles the correct coefficients, O(n log n).
+ * @warning the constant coefficient must not be 0.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the polynomial.
+ * @param n the number of coefficients of the inverse.
+ * @return the polynomial g such that a * g = 1 (mod x^n).
+ */
+polynomial *polynomialInverse(nttContext *context, polynomial *a, long long int n) {
+    assert(a->size > 0 && a->coefficient[0] != 0 && "the constant coefficient must be invertible");
+    assert(n > 0);
+
+    //The inverse modulo x^k.
+    polynomial *g = zeroPolynomial(1);
+
+    g->coefficient[0] = coefficientInverse(a->coefficient[0], context->p);
+    for (long long int k = 1; k < n; k *= 2) {
+        //a * g_k (mod x^(2k)), 1 + O(x^k).
+        polynomial *e = truncatedProduct(context, a, g, 2 * k);
+        //The next inverse.
+        polynomial *next = NULL;
+
+        //e = 2 - a * g_k
+        for (long long int i = 0; i < e->size; ++i) {
+            e->coefficient[i] = coefficientSub(0, e->coefficient[i], context->p);
+        }
+        if (e->size == 0) {
+            deletePolynomial(e);
+            e = zeroPolynomial(1);
+        }
+        e->coefficient[0] = coefficientSum(e->coefficient[0], 2 % context->p, context->p);
+
+        next = truncatedProduct(context, g, e, 2 * k);
+        deletePolynomial(e);
+        deletePolynomial(g);
+        g = next;
+    }
+    g->size = g->size < n ? g->size : n;
+
+    return trimPolynomial(g);
+}
+
+/**
+ * Computes the division with remainder of two polynomials modulo a prime.
+ * @details a = q * b + r with deg(r) < deg(b): the reversals satisfy rev(q) = rev(a) * rev(b)^(-1) (mod x^(deg(a) - deg(b) + 1)),
+ * @details so the quotient takes one Newton inverse and one product, O(n log n); schoolbook long division for short operands.
+ * @warning b must not be the zero polynomial.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the dividend.
+ * @param b the divisor.
+ * @param quotient the quotient, not computed if NULL.
+ * @param remainder the remainder, not computed if NULL.
+ */
+void polynomialDivision(nttContext *context, polynomial *a, polynomial *b, polynomial **quotient, polynomial **remainder) {
+    assert(b->size > 0 && "division by the zero polynomial");
+
+    //The number of coefficients of the quotient.
+    long long int k = a->size - b->size + 1;
+    //The quotient.
+    polynomial *q = NULL;
+    //The remainder.
+    polynomial *r = NULL;
+
+    if (k <= 0) {
+        q = zeroPolynomial(0);
+        r = slicePolynomial(a, 0, a->size);
+    } else if (k < SCHOOLBOOK_THRESHOLD || b->size < SCHOOLBOOK_THRESHOLD) {
+        //The inverse of the leading coefficient of the divisor.
+        unsigned long long int lead = coefficientInverse(b->coefficient[b->size - 1], context->p);
+
+        q = zeroPolynomial(k);
+        r = slicePolynomial(a, 0, a->size);
+        for (long long int i = k - 1; i >= 0; --i) {
+            //The coefficient of the quotient.
+            unsigned long long int c = coefficientProduct(r->coefficient[i + b->size - 1], lead, context->p);
+
+            q->coefficient[i] = c;
+            for (long long int j = 0; j < b->size; ++j) {
+                r->coefficient[i + j] = coefficientSub(r->coefficient[i + j], coefficientProduct(c, b->coefficient[j], context->p),
+                                                       context->p);
+            }
+        }
+        r->size = b->size - 1;
+        trimPolynomial(q);
+        trimPolynomial(r);
+    } else {
+        //The reversed divisor.
+        polynomial *rb = reversePolynomial(b, b->size);
+        //The inverse of the reversed divisor modulo x^k.
+        polynomial *inverse = polynomialInverse(context, rb, k);
+
+        reversedDivision(context, a, b, inverse, &q, &r);
+        deletePolynomial(rb);
+        deletePolynomial(inverse);
+    }
+
+    if (quotient != NULL) {
+        *quotient = q;
+    } else {
+        deletePolynomial(q);
+    }
+    if (remainder != NULL) {
+        *remainder = r;
+    } else {
+        deletePolynomial(r);
+    }
+}
+
+/**
+ * Computes the product of 2x2 polynomial matrices.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param l the left matrix, row-major.
+ * @param r the right matrix, row-major.
+ * @param res the product, row-major.
+ */
+static void matrixProduct(nttContext *context, polynomial **l, polynomial **r, polynomial **res) {
+    for (long long int i = 0; i < 2; ++i) {
+        for (long long int j = 0; j < 2; ++j) {
+            //The first term.
+            polynomial *first = polynomialProduct(context, l[2 * i], r[j]);
+            //The second term.
+            polynomial *second = polynomialProduct(context, l[2 * i + 1], r[2 + j]);
+
+            res[2 * i + j] = polynomialSum(context, first, second);
+            deletePolynomial(first);
+            deletePolynomial(second);
+        }
+    }
+}
+
+/**
+ * Applies a 2x2 polynomial matrix to a pair of polynomials.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param m the matrix, row-major.
+ * @param a the first polynomial.
+ * @param b the second polynomial.
+ * @param ra m_0 * a + m_1 * b.
+ * @param rb m_2 * a + m_3 * b.
+ */
+static void matrixApply(nttContext *context, polynomial **m, polynomial *a, polynomial *b, polynomial **ra, polynomial **rb) {
+    for (long long int i = 0; i < 2; ++i) {
+        //The first term.
+        polynomial *first = polynomialProduct(context, m[2 * i], a);
+        //The second term.
+        polynomial *second = polynomialProduct(context, m[2 * i + 1], b);
+
+        *(i == 0 ? ra : rb) = polynomialSum(context, first, second);
+        deletePolynomial(first);
+        deletePolynomial(second);
+    }
+}
+
+/**
+ * Deletes the polynomials of a 2x2 matrix.
+ *
+ * @param m the matrix.
+ */
+static void deleteMatrixPolynomials(polynomial **m) {
+    for (long long int i = 0; i < 4; ++i) {
+        deletePolynomial(m[i]);
+    }
+}
+
+/**
+ * Computes the half-GCD matrix of two polynomials.
+ * @details the product of the Euclidean steps (a, b) --> (b, a - q * b) that reduce deg(b) below h = ceil(deg(a) / 2):
+ * @details the quotients depend only on the highest coefficients, so the first half comes from a recursive call on a / x^h
+ * @details and b / x^h, one Euclidean step follows and the second half comes from a recursive call on the highest
+ * @details 2 * (deg(a') - h) coefficients, O(n log^2 n).
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the first polynomial.
+ * @param b the second polynomial, deg(b) < deg(a).
+ * @param res the matrix M, row-major, such that M * (a, b) = (a', b') with deg(a') >= h > deg(b').
+ */
+static void halfGcd(nttContext *context, polynomial *a, polynomial *b, polynomial **res) {
+    //The half of the degree of a.
+    long long int h = a->size / 2;
+
+    if (b->size - 1 < h) {
+        res[0] = zeroPolynomial(1);
+        res[1] = zeroPolynomial(0);
+        res[2] = zeroPolynomial(0);
+        res[3] = zeroPolynomial(1);
+        res[0]->coefficient[0] = 1;
+        res[3]->coefficient[0] = 1;
+        return;
+    }
+
+    //The highest coefficients of a.
+    polynomial *ha = slicePolynomial(a, h, a->size);
+    //The highest coefficients of b.
+    polynomial *hb = slicePolynomial(b, h, b->size);
+    //The matrix of the first half.
+    polynomial *first[4];
+    //The matrix of the Euclidean step.
+    polynomial *step[4];
+    //The matrix of the Euclidean step and the first half.
+    polynomial *middle[4];
+    //The matrix of the second half.
+    polynomial *second[4];
+    //The reduced pair.
+    polynomial *ra = NULL, *rb = NULL;
+    //The quotient and the remainder of the Euclidean step.
+    polynomial *q = NULL, *r = NULL;
+    //The offset of the second half.
+    long long int k = 0;
+
+    halfGcd(context, ha, hb, first);
+    deletePolynomial(ha);
+    deletePolynomial(hb);
+    matrixApply(context, first, a, b, &ra, &rb);
+    if (rb->size - 1 < h) {
+        for (long long int i = 0; i < 4; ++i) {
+            res[i] = first[i];
+        }
+        deletePolynomial(ra);
+        deletePolynomial(rb);
+        return;
+    }
+
+    polynomialDivision(context, ra, rb, &q, &r);
+    //the Euclidean step (a, b) --> (b, a - q * b)
+    step[0] = zeroPolynomial(0);
+    step[1] = zeroPolynomial(1);
+    step[2] = zeroPolynomial(1);
+    step[1]->coefficient[0] = 1;
+    step[2]->coefficient[0] = 1;
+    step[3] = polynomialSub(context, step[0], q);
+    matrixProduct(context, step, first, middle);
+    deleteMatrixPolynomials(step);
+    deleteMatrixPolynomials(first);
+    deletePolynomial(q);
+    deletePolynomial(ra);
+
+    k = 2 * h - (rb->size - 1);
+    ha = slicePolynomial(rb, k, rb->size);
+    hb = slicePolynomial(r, k, r->size);
+    halfGcd(context, ha, hb, second);
+    matrixProduct(context, second, middle, res);
+
+    deletePolynomial(ha);
+    deletePolynomial(hb);
+    deletePolynomial(rb);
+    deletePolynomial(r);
+    deleteMatrixPolynomials(second);
+    deleteMatrixPolynomials(middle);
+}
+
+/**
+ * Computes the greatest common divisor of two polynomials modulo a prime.
+ * @details half-GCD algorithm: a Euclidean step, then the half-GCD matrix halves the degrees, O(n log^2 n);
+ * @details the classical Euclidean algorithm below SCHOOLBOOK_THRESHOLD coefficients.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the first polynomial.
+ * @param b the second polynomial.
+ * @return the monic greatest common divisor, the zero polynomial if a and b are zero.
+ */
+polynomial *polynomialGcd(nttContext *context, polynomial *a, polynomial *b) {
+    //The first polynomial of the pair.
+    polynomial *x = slicePolynomial(a->size >= b->size ? a : b, 0, a->size + b->size);
+    //The second polynomial of the pair.
+    polynomial *y = slicePolynomial(a->size >= b->size ? b : a, 0, a->size + b->size);
+    //The inverse of the leading coefficient.
+    unsigned long long int lead = 0;
+
+    while (y->size > 0) {
+        //The remainder.
+        polynomial *r = NULL;
+
+        polynomialDivision(context, x, y, NULL, &r);
+        deletePolynomial(x);
+        x = y;
+        y = r;
+
+        if (y->size > 0 && x->size >= SCHOOLBOOK_THRESHOLD) {
+            //The half-GCD matrix.
+            polynomial *m[4];
+            //The reduced pair.
+            polynomial *rx = NULL, *ry = NULL;
+
+            halfGcd(context, x, y, m);
+            matrixApply(context, m, x, y, &rx, &ry);
+            deleteMatrixPolynomials(m);
+            deletePolynomial(x);
+            deletePolynomial(y);
+            x = rx;
+            y = ry;
+        }
+    }
+    deletePolynomial(y);
+
+    if (x->size > 0) {
+        lead = coefficientInverse(x->coefficient[x->size - 1], context->p);
+        for (long long int i = 0; i < x->size; ++i) {
+            x->coefficient[i] = coefficientProduct(x->coefficient[i], lead, context->p);
+        }
+    }
+
+    return x;
+}
+
+/**
+ * Builds the subproduct tree of points.
+ * @details the node v of the segment [l, r) stores the product m_v of (x - x_i) for l <= i < r, its children are 2v and 2v + 1;
+ * @details the leaves of at most TREE_LEAF points are multiplied one factor at a time.
+ * @details every node above the leaves also stores rev(m_v)^(-1) modulo x^(r - l + 1): the remainders going down the tree
+ * @details have fewer than r - l + 1 coefficients more than m_v below the root, so their divisions need no Newton iteration.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param points the points, the tree and the inverses are filled.
+ * @param v the node.
+ * @param l the first point of the segment, included.
+ * @param r the last point of the segment, excluded.
+ */
+static void buildTree(nttContext *context, polynomialPoints *points, long long int v, long long int l, long long int r) {
+    if (r - l <= TREE_LEAF) {
+        points->tree[v] = zeroPolynomial(r - l + 1);
+        points->tree[v]->coefficient[0] = 1;
+        //multiplication by (x - x_i), the coefficients are shifted up
+        for (long long int i = l; i < r; ++i) {
+            for (long long int j = i - l + 1; j >= 0; --j) {
+                points->tree[v]->coefficient[j] = coefficientSub(j > 0 ? points->tree[v]->coefficient[j - 1] : 0,
+                                                                 coefficientProduct(points->tree[v]->coefficient[j], points->x[i],
+                                                                                    context->p), context->p);
+            }
+        }
+        return;
+    }
+
+    //The reversal of the node.
+    polynomial *reversal = NULL;
+
+    buildTree(context, points, 2 * v, l, (l + r) / 2);
+    buildTree(context, points, 2 * v + 1, (l + r) / 2, r);
+    points->tree[v] = polynomialProduct(context, points->tree[2 * v], points->tree[2 * v + 1]);
+    reversal = reversePolynomial(points->tree[v], points->tree[v]->size);
+    points->inverse[v] = polynomialInverse(context, reversal, r - l + 1);
+    deletePolynomial(reversal);
+}
+
+/**
+ * Deletes the subproduct tree of points.
+ *
+ * @param points the points, the tree and the inverses are deleted.
+ * @param v the node.
+ * @param l the first point of the segment, included.
+ * @param r the last point of the segment, excluded.
+ */
+static void deleteTree(polynomialPoints *points, long long int v, long long int l, long long int r) {
+    if (r - l > TREE_LEAF) {
+        deleteTree(points, 2 * v, l, (l + r) / 2);
+        deleteTree(points, 2 * v + 1, (l + r) / 2, r);
+        deletePolynomial(points->inverse[v]);
+    }
+    deletePolynomial(points->tree[v]);
+}
+
+/**
+ * Evaluates a polynomial with the remainder tree.
+ * @details a(x_i) = (a mod m_v)(x_i) for every point of the segment of the node v: the remainders go down the tree,
+ * @details the divisions use the inverses stored in the tree, the leaves are evaluated with Horner's rule.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param points the points and their subproduct tree.
+ * @param v the node.
+ * @param l the first point of the segment, included.
+ * @param r the last point of the segment, excluded.
+ * @param a the polynomial, a remainder modulo the parent of v.
+ * @param res the values.
+ */
+static void evaluateTree(nttContext *context, polynomialPoints *points, long long int v, long long int l, long long int r, polynomial *a,
+                         unsigned long long int *res) {
+    if (r - l <= TREE_LEAF) {
+        for (long long int i = l; i < r; ++i) {
+            //The value.
+            unsigned long long int y = 0;
+
+            for (long long int j = a->size - 1; j >= 0; --j) {
+                y = coefficientSum(coefficientProduct(y, points->x[i], context->p), a->coefficient[j], context->p);
+            }
+            res[i] = y;
+        }
+        return;
+    }
+
+    //The number of coefficients of the quotient.
+    long long int k = a->size - points->tree[v]->size + 1;
+    //The quotient.
+    polynomial *quotient = NULL;
+    //The remainder modulo the node.
+    polynomial *remainder = NULL;
+
+    //the stored inverse is precise enough below the root, the short quotients are faster with the schoolbook division
+    if (k >= SCHOOLBOOK_THRESHOLD && k <= r - l + 1) {
+        reversedDivision(context, a, points->tree[v], points->inverse[v], &quotient, &remainder);
+        deletePolynomial(quotient);
+    } else {
+        polynomialDivision(context, a, points->tree[v], NULL, &remainder);
+    }
+    evaluateTree(context, points, 2 * v, l, (l + r) / 2, remainder, res);
+    evaluateTree(context, points, 2 * v + 1, (l + r) / 2, r, remainder, res);
+    deletePolynomial(remainder);
+}
+
+/**
+ * Combines the interpolation weights with the subproduct tree.
+ * @details P_v = sum(c_i * m_v / (x - x_i)) for the points of the segment of v: P_v = P_(2v) * m_(2v+1) + P_(2v+1) * m_(2v),
+ * @details the leaves divide m_v by every (x - x_i) with synthetic division.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param points the points and their subproduct tree.
+ * @param v the node.
+ * @param l the first point of the segment, included.
+ * @param r the last point of the segment, excluded.
+ * @param c the weights, y_i / m'(x_i).
+ * @return the polynomial P_v.
+ */
+static polynomial *interpolateTree(nttContext *context, polynomialPoints *points, long long int v, long long int l, long long int r,
+                                   unsigned long long int *c) {
+    if (r - l <= TREE_LEAF) {
+        //The polynomial of the leaf.
+        polynomial *res = zeroPolynomial(r - l);
+
+        for (long long int i = l; i < r; ++i) {
+            //The coefficient of m_v / (x - x_i), from the highest.
+            unsigned long long int q = 0;
+
+            for (long long int j = r - l; j >= 1; --j) {
+                q = coefficientSum(points->tree[v]->coefficient[j], coefficientProduct(q, points->x[i], context->p), context->p);
+                res->coefficient[j - 1] = coefficientSum(res->coefficient[j - 1], coefficientProduct(q, c[i], context->p), context->p);
+            }
+        }
+        return trimPolynomial(res);
+    }
+
+    //The polynomial of the left child.
+    polynomial *left = interpolateTree(context, points, 2 * v, l, (l + r) / 2, c);
+    //The polynomial of the right child.
+    polynomial *right = interpolateTree(context, points, 2 * v + 1, (l + r) / 2, r, c);
+    //The left term.
+    polynomial *first = polynomialProduct(context, left, points->tree[2 * v + 1]);
+    //The right term.
+    polynomial *second = polynomialProduct(context, right, points->tree[2 * v]);
+    //The polynomial of the node.
+    polynomial *res = polynomialSum(context, first, second);
+
+    deletePolynomial(left);
+    deletePolynomial(right);
+    deletePolynomial(first);
+    deletePolynomial(second);
+    return res;
+}
+
+/**
+ * Creates the subproduct tree of points modulo a prime, for many evaluations and interpolations at the same points.
+ * @details every node stores the product of its factors (x - x_i) and, above the leaves, the inverse of its reversal,
+ * @details so the divisions of the evaluations need no Newton iteration, O(n log^2 n).
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param numberOfPoints the number of points.
+ * @param x the points, lower than p; they are copied.
+ * @return the points with their subproduct tree.
+ */
+polynomialPoints *createPolynomialPoints(nttContext *context, long long int numberOfPoints, unsigned long long int *x) {
+    assert(numberOfPoints >= 0);
+
+    //The points.
+    polynomialPoints *points = malloc(sizeof(polynomialPoints));
+    assert(points != NULL);
+
+    points->numberOfPoints = numberOfPoints;
+    points->x = malloc((numberOfPoints > 0 ? numberOfPoints : 1) * sizeof(unsigned long long int));
+    points->tree = calloc(numberOfPoints > 0 ? 4 * numberOfPoints : 1, sizeof(polynomial *));
+    points->inverse = calloc(numberOfPoints > 0 ? 4 * numberOfPoints : 1, sizeof(polynomial *));
+    assert(points->x != NULL && points->tree != NULL && points->inverse != NULL);
+    points->weight = NULL;
+
+    for (long long int i = 0; i < numberOfPoints; ++i) {
+        points->x[i] = x[i];
+    }
+    if (numberOfPoints > 0) {
+        buildTree(context, points, 1, 0, numberOfPoints);
+    }
+
+    return points;
+}
+
+/**
+ * Evaluates a polynomial at many points modulo a prime using their subproduct tree.
+ * @details the remainders of the polynomial go down the tree, two products per node, O(n log^2 n).
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param points the points and their subproduct tree.
+ * @param a the polynomial.
+ * @param res the values a(x_i).
+ */
+void polynomialEvaluateFromPoints(nttContext *context, polynomialPoints *points, polynomial *a, unsigned long long int *res) {
+    if (points->numberOfPoints > 0) {
+        evaluateTree(context, points, 1, 0, points->numberOfPoints, a, res);
+    }
+}
+
+/**
+ * Evaluates a polynomial at many points modulo a prime.
+ * @details see polynomialEvaluateFromPoints, the subproduct tree is built for this evaluation only.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the polynomial.
+ * @param numberOfPoints the number of points.
+ * @param x the points, lower than p.
+ * @param res the values a(x_i).
+ */
+void polynomialEvaluate(nttContext *context, polynomial *a, long long int numberOfPoints, unsigned long long int *x,
+                        unsigned long long int *res) {
+    //The points and their subproduct tree.
+    polynomialPoints *points = createPolynomialPoints(context, numberOfPoints, x);
+
+    polynomialEvaluateFromPoints(context, points, a, res);
+    deletePolynomialPoints(points);
+}
+
+/**
+ * Computes the interpolation polynomial of points modulo a prime using their subproduct tree.
+ * @details Lagrange's formula P = sum(y_i / m'(x_i) * m / (x - x_i)) with m = prod(x - x_i): the weights 1 / m'(x_i) come from
+ * @details the multipoint evaluation of m' at the first interpolation and are kept with the points,
+ * @details then the terms are combined up the tree, O(n log^2 n).
+ * @warning the points must be distinct.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param points the points and their subproduct tree.
+ * @param y the values, lower than p.
+ * @return the polynomial P of degree lower than numberOfPoints with P(x_i) = y_i.
+ */
+polynomial *polynomialInterpolateFromPoints(nttContext *context, polynomialPoints *points, unsigned long long int *y) {
+    //The number of points.
+    long long int n = points->numberOfPoints;
+
+    if (n <= 0) {
+        return zeroPolynomial(0);
+    }
+
+    //The weights y_i / m'(x_i).
+    unsigned long long int *c = malloc(n * sizeof(unsigned long long int));
+    assert(c != NULL);
+    //The interpolation polynomial.
+    polynomial *res = NULL;
+
+    if (points->weight == NULL) {
+        //The derivative of m.
+        polynomial *derivative = zeroPolynomial(points->tree[1]->size - 1);
+
+        points->weight = malloc(n * sizeof(unsigned long long int));
+        assert(points->weight != NULL);
+        for (long long int i = 1; i < points->tree[1]->size; ++i) {
+            derivative->coefficient[i - 1] = coefficientProduct(points->tree[1]->coefficient[i], (unsigned long long int) i % context->p,
+                                                                context->p);
+        }
+        trimPolynomial(derivative);
+
+        evaluateTree(context, points, 1, 0, n, derivative, points->weight);
+        for (long long int i = 0; i < n; ++i) {
+            assert(points->weight[i] != 0 && "the points must be distinct");
+            points->weight[i] = coefficientInverse(points->weight[i], context->p);
+        }
+        deletePolynomial(derivative);
+    }
+
+    for (long long int i = 0; i < n; ++i) {
+        c[i] = coefficientProduct(y[i], points->weight[i], context->p);
+    }
+    res = interpolateTree(context, points, 1, 0, n, c);
+
+    free(c);
+    return res;
+}
+
+/**
+ * Computes the interpolation polynomial of points modulo a prime.
+ * @details see polynomialInterpolateFromPoints, the subproduct tree is built for this interpolation only.
+ * @warning the points must be distinct.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param numberOfPoints the number of points.
+ * @param x the points, lower than p.
+ * @param y the values, lower than p.
+ * @return the polynomial P of degree lower than numberOfPoints with P(x_i) = y_i.
+ */
+polynomial *polynomialInterpolate(nttContext *context, long long int numberOfPoints, unsigned long long int *x, unsigned long long int *y) {
+    //The points and their subproduct tree.
+    polynomialPoints *points = createPolynomialPoints(context, numberOfPoints, x);
+    //The interpolation polynomial.
+    polynomial *res = polynomialInterpolateFromPoints(context, points, y);
+
+    deletePolynomialPoints(points);
+    return res;
+}
+
+/**
+ * Deletes the subproduct tree of points.
+ *
+ * @param points the points to be deleted.
+ */
+void deletePolynomialPoints(polynomialPoints *points) {
+    if (points->numberOfPoints > 0) {
+        deleteTree(points, 1, 0, points->numberOfPoints);
+    }
+    free(points->x);
+    free(points->tree);
+    free(points->inverse);
+    free(points->weight);
+    free(points);
+}
+
+/**
+ * Deletes a polynomial.
+ *
+ * @param a the polynomial to be deleted.
+ */
+void deletePolynomial(polynomial *a) {
+    free(a->coefficient);
+    free(a);
+}
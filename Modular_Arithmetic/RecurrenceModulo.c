@@ -0,0 +1,459 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * Computes the product of two coefficients modulo p.
+ *
+ * @param a the first coefficient, lower than p.
+ * @param b the second coefficient, lower than p.
+ * @param p the prime.
+ * @return the product modulo p.
+ */
+static unsigned long long int recurrenceProduct(unsigned long long int a, unsigned long long int b, unsigned long long int p) {
+    return (unsigned long long int) ((unsigned __int128) a * b % p);
+}
+
+/**
+ * Computes the difference of two coefficients modulo p.
+ *
+ * @param a the minuend, lower than p.
+ * @param b the subtrahend, lower than p.
+ * @param p the prime.
+ * @return the difference modulo p.
+ */
+static unsigned long long int recurrenceSub(unsigned long long int a, unsigned long long int b, unsigned long long int p) {
+    return a >= b ? a - b : a - b + p;
+}
+
+/**
+ * Computes the inverse of a coefficient modulo p.
+ * @details Fermat's little theorem: a^(-1) = a^(p-2) (mod p).
+ *
+ * @param a the coefficient, lower than p and not 0.
+ * @param p the prime.
+ * @return the inverse modulo p.
+ */
+static unsigned long long int recurrenceInverse(unsigned long long int a, unsigned long long int p) {
+    //The result.
+    unsigned long long int res = 1;
+    //The exponent.
+    unsigned long long int exp = p - 2;
+
+    while (exp > 0) {
+        if (exp % 2 == 1) {
+            res = recurrenceProduct(res, a, p);
+        }
+        exp >>= 1;
+        a = recurrenceProduct(a, a, p);
+    }
+
+    return res;
+}
+
+/**
+ * Creates the reversed polynomial x^(size-1) * a(1/x), modulo x^n.
+ *
+ * @param a the polynomial, with at most size coefficients.
+ * @param size the number of coefficients of the reversal.
+ * @param n the number of coefficients kept.
+ * @return the reversed polynomial modulo x^n.
+ */
+static polynomial *reverseModulo(polynomial *a, long long int size, long long int n) {
+    //The coefficients of the reversal.
+    unsigned long long int *coefficient = calloc(size > 0 ? size : 1, sizeof(unsigned long long int));
+    assert(coefficient != NULL);
+    //The reversed polynomial.
+    polynomial *res = NULL;
+
+    for (long long int i = 0; i < a->size; ++i) {
+        coefficient[size - 1 - i] = a->coefficient[i];
+    }
+    res = createPolynomial(size < n ? size : n, coefficient);
+
+    free(coefficient);
+    return res;
+}
+
+/**
+ * Computes the remainder modulo the characteristic polynomial of a recurrence.
+ * @details Barrett reduction of polynomials: the quotient of a by Q is rev(rev(a) * rev(Q)^(-1) mod x^k), with the inverse
+ * @details computed once, then a - q * Q; two products instead of the Newton inverse of every polynomialDivision.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param a the polynomial, with at most 2d - 1 coefficients; it is deleted.
+ * @param q the characteristic polynomial, monic of degree d.
+ * @param inverse rev(Q)^(-1) modulo x^(d-1).
+ * @return a modulo Q, with at most d coefficients.
+ */
+static polynomial *characteristicRemainder(nttContext *context, polynomial *a, polynomial *q, polynomial *inverse) {
+    //The number of coefficients of the quotient.
+    long long int k = a->size - (q->size - 1);
+
+    if (k <= 0) {
+        return a;
+    }
+
+    //The reversed polynomial modulo x^k.
+    polynomial *ra = reverseModulo(a, a->size, k);
+    //The reversed quotient.
+    polynomial *rq = polynomialProduct(context, ra, inverse);
+    //The quotient.
+    polynomial *quotient = NULL;
+    //The product of the quotient and Q.
+    polynomial *qq = NULL;
+    //The remainder.
+    polynomial *res = NULL;
+
+    rq->size = rq->size < k ? rq->size : k;
+    quotient = reverseModulo(rq, k, k);
+    qq = polynomialProduct(context, quotient, q);
+    res = polynomialSub(context, a, qq);
+
+    deletePolynomial(ra);
+    deletePolynomial(rq);
+    deletePolynomial(quotient);
+    deletePolynomial(qq);
+    deletePolynomial(a);
+    return res;
+}
+
+/**
+ * Computes the product by x modulo the characteristic polynomial of a recurrence.
+ * @details the coefficients are shifted up, then the leading one is removed with a multiple of Q, O(d).
+ *
+ * @param a the polynomial, with at most d coefficients; it is deleted.
+ * @param q the characteristic polynomial, monic of degree d.
+ * @param p the prime.
+ * @return x * a modulo Q, with at most d coefficients.
+ */
+static polynomial *characteristicShift(polynomial *a, polynomial *q, unsigned long long int p) {
+    //The coefficients of x * a.
+    unsigned long long int *coefficient = calloc(a->size + 1, sizeof(unsigned long long int));
+    assert(coefficient != NULL);
+    //The leading coefficient, removed if it is at x^d.
+    unsigned long long int lead = a->size == q->size - 1 ? a->coefficient[a->size - 1] : 0;
+    //The product.
+    polynomial *res = NULL;
+
+    for (long long int i = 0; i < a->size; ++i) {
+        coefficient[i + 1] = a->coefficient[i];
+    }
+    for (long long int i = 0; i < q->size && lead != 0; ++i) {
+        coefficient[i] = recurrenceSub(coefficient[i], recurrenceProduct(lead, q->coefficient[i], p), p);
+    }
+    res = createPolynomial(a->size + 1, coefficient);
+
+    free(coefficient);
+    deletePolynomial(a);
+    return res;
+}
+
+/**
+ * Computes the term of a recurrence from the remainder of x^k modulo its characteristic polynomial.
+ * @details x^k = sum(r_i * x^i) (mod Q) and the shift x --> s_(n+1) is annihilated by Q, so s_k = sum(r_i * s_i).
+ *
+ * @param recurrence the linear recurrence.
+ * @param r the remainder, with at most d coefficients.
+ * @param p the prime.
+ * @return the term s_k.
+ */
+static unsigned long long int termFromRemainder(linearRecurrence *recurrence, polynomial *r, unsigned long long int p) {
+    //The term.
+    unsigned __int128 res = 0;
+
+    for (long long int i = 0; i < r->size; ++i) {
+        res = (res + recurrenceProduct(r->coefficient[i], recurrence->initial[i], p)) % p;
+    }
+
+    return (unsigned long long int) res;
+}
+
+/**
+ * Creates the characteristic polynomial of a recurrence and the inverse of its reversal.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param recurrence the linear recurrence.
+ * @param q the characteristic polynomial Q = x^d - c_1 * x^(d-1) - ... - c_d.
+ * @param inverse rev(Q)^(-1) = (1 - c_1 * x - ... - c_d * x^d)^(-1) modulo x^(d-1).
+ */
+static void characteristicPolynomial(nttContext *context, linearRecurrence *recurrence, polynomial **q, polynomial **inverse) {
+    //The number of coefficients of Q.
+    long long int size = recurrence->order + 1;
+    //The coefficients of Q.
+    unsigned long long int *coefficient = malloc(size * sizeof(unsigned long long int));
+    assert(coefficient != NULL);
+    //The reversal of Q.
+    polynomial *reversal = NULL;
+
+    coefficient[size - 1] = 1;
+    for (long long int i = 1; i < size; ++i) {
+        coefficient[size - 1 - i] = recurrenceSub(0, recurrence->coefficient[i - 1] % context->p, context->p);
+    }
+    *q = createPolynomial(size, coefficient);
+    reversal = reverseModulo(*q, size, size);
+    *inverse = polynomialInverse(context, reversal, recurrence->order > 1 ? recurrence->order - 1 : 1);
+
+    deletePolynomial(reversal);
+    free(coefficient);
+}
+
+
+/**
+ * Creates a linear recurrence s_n = c_1 * s_(n-1) + ... + c_d * s_(n-d) modulo a prime.
+ *
+ * @param order the order d of the recurrence.
+ * @param coefficient the coefficients c_1, ..., c_d, lower than p; they are copied.
+ * @param initial the initial terms s_0, ..., s_(d-1), lower than p; they are copied.
+ * @return the linear recurrence.
+ */
+linearRecurrence *createLinearRecurrence(long long int order, unsigned long long int *coefficient, unsigned long long int *initial) {
+    assert(order >= 0);
+
+    //The linear recurrence.
+    linearRecurrence *recurrence = malloc(sizeof(linearRecurrence));
+    assert(recurrence != NULL);
+
+    recurrence->order = order;
+    recurrence->coefficient = malloc((order > 0 ? order : 1) * sizeof(unsigned long long int));
+    recurrence->initial = malloc((order > 0 ? order : 1) * sizeof(unsigned long long int));
+    assert(recurrence->coefficient != NULL && recurrence->initial != NULL);
+
+    for (long long int i = 0; i < order; ++i) {
+        recurrence->coefficient[i] = coefficient[i];
+        recurrence->initial[i] = initial[i];
+    }
+
+    return recurrence;
+}
+
+/**
+ * Finds the shortest linear recurrence that generates a sequence modulo a prime.
+ * @details Berlekamp-Massey algorithm: the connection polynomial C = 1 - c_1 * x - ... - c_L * x^L is corrected
+ * @details by the last one before the latest change of length every time the discrepancy d_n = s_n - sum(c_i * s_(n-i))
+ * @details is not 0, O(n^2). 2L terms determine a recurrence of order L.
+ *
+ * @param context the precomputation of the transform modulo p, only p is needed.
+ * @param numberOfTerms the number of terms.
+ * @param terms the terms s_0, s_1, ..., lower than p.
+ * @return the minimal linear recurrence, with the first terms as initial terms.
+ */
+linearRecurrence *BerlekampMasseyAlgorithm(nttContext *context, long long int numberOfTerms, unsigned long long int *terms) {
+    assert(numberOfTerms >= 0);
+
+    //The prime.
+    unsigned long long int p = context->p;
+    //The connection polynomial.
+    unsigned long long int *c = calloc(numberOfTerms + 1, sizeof(unsigned long long int));
+    //The connection polynomial before the latest change of length.
+    unsigned long long int *b = calloc(numberOfTerms + 1, sizeof(unsigned long long int));
+    //The copy of the connection polynomial.
+    unsigned long long int *t = calloc(numberOfTerms + 1, sizeof(unsigned long long int));
+    assert(c != NULL && b != NULL && t != NULL);
+    //The length of the recurrence.
+    long long int length = 0;
+    //The number of terms since the latest change of length.
+    long long int shift = 1;
+    //The discrepancy at the latest change of length.
+    unsigned long long int last = 1;
+    //The recurrence.
+    linearRecurrence *res = NULL;
+
+    c[0] = 1;
+    b[0] = 1;
+    for (long long int n = 0; n < numberOfTerms; ++n) {
+        //The discrepancy.
+        unsigned __int128 d = terms[n] % p;
+        //The factor of the correction.
+        unsigned long long int factor = 0;
+
+        for (long long int i = 1; i <= length; ++i) {
+            d = (d + recurrenceProduct(c[i], terms[n - i] % p, p)) % p;
+        }
+        if (d == 0) {
+            shift++;
+            continue;
+        }
+
+        factor = recurrenceProduct((unsigned long long int) d, recurrenceInverse(last, p), p);
+        if (2 * length <= n) {
+            for (long long int i = 0; i <= length; ++i) {
+                t[i] = c[i];
+            }
+        }
+        //C = C - d / last * x^shift * B
+        for (long long int i = 0; i + shift <= numberOfTerms; ++i) {
+            c[i + shift] = recurrenceSub(c[i + shift], recurrenceProduct(factor, b[i], p), p);
+        }
+        if (2 * length <= n) {
+            for (long long int i = 0; i <= numberOfTerms; ++i) {
+                b[i] = i <= length ? t[i] : 0;
+            }
+            length = n + 1 - length;
+            last = (unsigned long long int) d;
+            shift = 1;
+        } else {
+            shift++;
+        }
+    }
+
+    //s_n = -C_1 * s_(n-1) - ... - C_L * s_(n-L)
+    for (long long int i = 1; i <= length; ++i) {
+        t[i - 1] = recurrenceSub(0, c[i], p);
+    }
+    res = createLinearRecurrence(length, t, terms);
+
+    free(c);
+    free(b);
+    free(t);
+    return res;
+}
+
+/**
+ * Computes a term of a linear recurrence modulo a prime.
+ * @details Fiduccia's algorithm: s_k = sum(r_i * s_i) with r = x^k modulo the characteristic polynomial Q,
+ * @details left-to-right square and multiply, the multiplications by x are shifts, with the Barrett reduction of polynomials,
+ * @details O(d log d log k).
+ * @warning 2d must not be greater than the maxLength of the context.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param recurrence the linear recurrence.
+ * @param k the index of the term.
+ * @return the term s_k.
+ */
+unsigned long long int linearRecurrenceTerm(nttContext *context, linearRecurrence *recurrence, unsigned long long int k) {
+    //The characteristic polynomial.
+    polynomial *q = NULL;
+    //The inverse of its reversal.
+    polynomial *inverse = NULL;
+    //x^k modulo Q, from 1.
+    polynomial *r = NULL;
+    //The coefficient of 1.
+    unsigned long long int one = 1;
+    //The term.
+    unsigned long long int res = 0;
+
+    if (recurrence->order == 0) {
+        return 0;
+    }
+    if (k < (unsigned long long int) recurrence->order) {
+        return recurrence->initial[k] % context->p;
+    }
+
+    characteristicPolynomial(context, recurrence, &q, &inverse);
+    r = createPolynomial(1, &one);
+    for (long long int bit = 63 - __builtin_clzll(k); bit >= 0; --bit) {
+        //The square.
+        polynomial *square = characteristicRemainder(context, polynomialProduct(context, r, r), q, inverse);
+
+        deletePolynomial(r);
+        r = (k >> bit & 1) == 1 ? characteristicShift(square, q, context->p) : square;
+    }
+    res = termFromRemainder(recurrence, r, context->p);
+
+    deletePolynomial(r);
+    deletePolynomial(q);
+    deletePolynomial(inverse);
+    return res;
+}
+
+/**
+ * Computes many terms of a linear recurrence modulo a prime.
+ * @details Fiduccia's algorithm with shared squarings: x^(2^j) modulo the characteristic polynomial is computed once
+ * @details for every bit j of the largest index, then every x^k is the product of the powers of its bits,
+ * @details O(d log d (log(max k) + sum(popcount(k)))).
+ * @warning 2d must not be greater than the maxLength of the context.
+ *
+ * @param context the precomputation of the transform modulo p.
+ * @param recurrence the linear recurrence.
+ * @param numberOfIndices the number of indices.
+ * @param k the indices of the terms.
+ * @param res the terms s_k.
+ */
+void linearRecurrenceTerms(nttContext *context, linearRecurrence *recurrence, long long int numberOfIndices, unsigned long long int *k,
+                           unsigned long long int *res) {
+    //The order.
+    long long int d = recurrence->order;
+    //The largest index.
+    unsigned long long int largest = 0;
+    //The number of bits of the largest index.
+    long long int bits = 0;
+    //The powers x^(2^j) modulo Q.
+    polynomial *power[64];
+    //The characteristic polynomial.
+    polynomial *q = NULL;
+    //The inverse of its reversal.
+    polynomial *inverse = NULL;
+    //The coefficients of x.
+    unsigned long long int x[2] = {0, 1};
+
+    //the zero sequence
+    if (d == 0) {
+        for (long long int i = 0; i < numberOfIndices; ++i) {
+            res[i] = 0;
+        }
+        return;
+    }
+
+    for (long long int i = 0; i < numberOfIndices; ++i) {
+        if (k[i] < (unsigned long long int) d) {
+            res[i] = recurrence->initial[k[i]] % context->p;
+        } else if (k[i] > largest) {
+            largest = k[i];
+        }
+    }
+    if (largest == 0) {
+        return;
+    }
+
+    characteristicPolynomial(context, recurrence, &q, &inverse);
+    //x modulo Q, it is c_1 if d = 1
+    power[0] = characteristicRemainder(context, createPolynomial(2, x), q, inverse);
+    for (bits = 1; bits < 64 && (largest >> bits) != 0; ++bits) {
+        power[bits] = characteristicRemainder(context, polynomialProduct(context, power[bits - 1], power[bits - 1]), q, inverse);
+    }
+
+    for (long long int i = 0; i < numberOfIndices; ++i) {
+        //x^k modulo Q.
+        polynomial *r = NULL;
+
+        if (k[i] < (unsigned long long int) d) {
+            continue;
+        }
+        for (long long int j = 0; j < bits; ++j) {
+            if ((k[i] >> j & 1) == 0) {
+                continue;
+            }
+            if (r == NULL) {
+                r = createPolynomial(power[j]->size, power[j]->coefficient);
+            } else {
+                //The product of the powers so far.
+                polynomial *next = characteristicRemainder(context, polynomialProduct(context, r, power[j]), q, inverse);
+
+                deletePolynomial(r);
+                r = next;
+            }
+        }
+        res[i] = termFromRemainder(recurrence, r, context->p);
+        deletePolynomial(r);
+    }
+
+    for (long long int j = 0; j < bits; ++j) {
+        deletePolynomial(power[j]);
+    }
+    deletePolynomial(q);
+    deletePolynomial(inverse);
+}
+
+/**
+ * Deletes a linear recurrence.
+ *
+ * @param recurrence the linear recurrence to be deleted.
+ */
+void deleteLinearRecurrence(linearRecurrence *recurrence) {
+    free(recurrence->coefficient);
+    free(recurrence->initial);
+    free(recurrence);
+}
@@ -0,0 +1,206 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * Computes the product modulo a prime of the basis.
+ * @details Barrett reduction: q = floor(a * b * floor(2^64 / p) / 2^64) is at most one below floor(a * b / p),
+ * @details so a multiplication, a high multiplication and one conditional subtraction replace the division.
+ *
+ * @param a the first factor, reduced.
+ * @param b the second factor, reduced.
+ * @param p the prime, lower than 2^31.
+ * @param barrett the Barrett constant of the prime, floor(2^64 / p).
+ * @return the product modulo p.
+ */
+static long long int barrettProduct(long long int a, long long int b, long long int p, unsigned long long int barrett) {
+    //The product, lower than 2^62.
+    unsigned long long int t = (unsigned long long int) a * (unsigned long long int) b;
+    //The remainder, lower than 2p.
+    unsigned long long int r = t - (unsigned long long int) (((unsigned __int128) t * barrett) >> 64) * (unsigned long long int) p;
+
+    return (long long int) (r >= (unsigned long long int) p ? r - (unsigned long long int) p : r);
+}
+
+
+/**
+ * Creates a basis of a residue number system.
+ * @details the basis is made of the largest primes below bound, found with the Miller-Rabin test,
+ * @details so the residues of a number fit in 32 bits and the product of two of them in 64 bits.
+ *
+ * @param size the number of primes of the basis.
+ * @param bound the upper bound of the primes, excluded, at most 2^31.
+ * @return the basis.
+ */
+rnsBasis *createRnsBasis(long long int size, long long int bound) {
+    assert(size > 0 && bound <= (1LL << 31));
+
+    //The basis.
+    rnsBasis *basis = malloc(sizeof(rnsBasis));
+    assert(basis != NULL);
+    //The candidate prime.
+    long long int p = bound - 1;
+
+    basis->size = size;
+    basis->prime = malloc(size * sizeof(long long int));
+    basis->barrett = malloc(size * sizeof(unsigned long long int));
+    assert(basis->prime != NULL && basis->barrett != NULL);
+
+    for (long long int i = 0; i < size; ++i, --p) {
+        while (p > 2 && !MillerRabinTest(p)) {
+            p--;
+        }
+        assert(p > 2 && "not enough primes below the bound");
+
+        basis->prime[i] = p;
+        basis->barrett[i] = ~0ULL / (unsigned long long int) p;
+    }
+    basis->crt = createCrtContext(size, basis->prime);
+
+    return basis;
+}
+
+/**
+ * Computes the residues of a number in a residue number system.
+ *
+ * @param basis the basis of the residue number system.
+ * @param n the number.
+ * @param res the residues, one per prime of the basis.
+ */
+void rnsFromInteger(rnsBasis *basis, unsigned long long int n, long long int *res) {
+    for (long long int i = 0; i < basis->size; ++i) {
+        res[i] = (long long int) (n % (unsigned long long int) basis->prime[i]);
+    }
+}
+
+/**
+ * Computes the residues of a multi-word number in a residue number system.
+ * @details Horner's rule on the words, from the most significant: r = r * 2^64 + w (mod p).
+ *
+ * @param basis the basis of the residue number system.
+ * @param numberOfWords the number of 64-bit words of the number.
+ * @param words the number, least significant word first.
+ * @param res the residues, one per prime of the basis.
+ */
+void rnsFromWords(rnsBasis *basis, long long int numberOfWords, unsigned long long int *words, long long int *res) {
+    for (long long int i = 0; i < basis->size; ++i) {
+        //The prime of the basis.
+        unsigned long long int p = (unsigned long long int) basis->prime[i];
+        //The residue.
+        unsigned long long int r = 0;
+
+        for (long long int j = numberOfWords - 1; j >= 0; --j) {
+            r = (unsigned long long int) ((((unsigned __int128) r << 64) | words[j]) % p);
+        }
+        res[i] = (long long int) r;
+    }
+}
+
+/**
+ * Computes the number represented by residues in a residue number system.
+ * @details Garner's algorithm on the Chinese Reminder Theorem precomputation of the basis.
+ *
+ * @param basis the basis of the residue number system.
+ * @param x the residues.
+ * @param res the number modulo the product of the primes, basis->crt->words 64-bit words, least significant first.
+ */
+void rnsToWords(rnsBasis *basis, long long int *x, unsigned long long int *res) {
+    crtReconstructWords(basis->crt, x, res);
+}
+
+/**
+ * Computes the sum in a residue number system.
+ * @details every residue is independent: no carry.
+ *
+ * @param basis the basis of the residue number system.
+ * @param x the residues of the first addend.
+ * @param y the residues of the second addend.
+ * @param res the residues of the sum, it may be x or y.
+ */
+void rnsSum(rnsBasis *basis, long long int *x, long long int *y, long long int *res) {
+    for (long long int i = 0; i < basis->size; ++i) {
+        //The sum, lower than 2^32.
+        long long int s = x[i] + y[i];
+
+        res[i] = s >= basis->prime[i] ? s - basis->prime[i] : s;
+    }
+}
+
+/**
+ * Computes the difference in a residue number system.
+ * @details every residue is independent: no borrow.
+ *
+ * @param basis the basis of the residue number system.
+ * @param x the residues of the minuend.
+ * @param y the residues of the subtrahend.
+ * @param res the residues of the difference, it may be x or y.
+ */
+void rnsSub(rnsBasis *basis, long long int *x, long long int *y, long long int *res) {
+    for (long long int i = 0; i < basis->size; ++i) {
+        //The difference, greater than -2^31.
+        long long int d = x[i] - y[i];
+
+        res[i] = d < 0 ? d + basis->prime[i] : d;
+    }
+}
+
+/**
+ * Computes the product in a residue number system.
+ * @details every residue is independent: one Barrett product per prime, no carry.
+ *
+ * @param basis the basis of the residue number system.
+ * @param x the residues of the first factor.
+ * @param y the residues of the second factor.
+ * @param res the residues of the product, it may be x or y.
+ */
+void rnsProduct(rnsBasis *basis, long long int *x, long long int *y, long long int *res) {
+    for (long long int i = 0; i < basis->size; ++i) {
+        res[i] = barrettProduct(x[i], y[i], basis->prime[i], basis->barrett[i]);
+    }
+}
+
+/**
+ * Computes the residues of a number in another residue number system.
+ * @details base extension: the mixed-radix digits v_i of the number come from Garner's algorithm in the first basis,
+ * @details then x = v_0 + m_0 * (v_1 + m_1 * (...)) is evaluated by Horner's rule modulo every prime of the second basis.
+ *
+ * @param from the basis of the residues.
+ * @param x the residues in the first basis.
+ * @param to the basis of the result.
+ * @param res the residues in the second basis, the number modulo the product of the primes of the first basis.
+ */
+void rnsBaseExtension(rnsBasis *from, long long int *x, rnsBasis *to, long long int *res) {
+    //The mixed-radix digits.
+    long long int *digits = malloc(from->size * sizeof(long long int));
+    assert(digits != NULL);
+
+    crtMixedRadix(from->crt, x, digits);
+    for (long long int i = 0; i < to->size; ++i) {
+        //The prime of the second basis.
+        long long int q = to->prime[i];
+        //The residue modulo q.
+        long long int r = 0;
+
+        for (long long int j = from->size - 1; j >= 0; --j) {
+            r = barrettProduct(r, from->prime[j] % q, q, to->barrett[i]) + digits[j] % q;
+            r = r >= q ? r - q : r;
+        }
+        res[i] = r;
+    }
+
+    free(digits);
+}
+
+/**
+ * Deletes a basis of a residue number system.
+ *
+ * @param basis the basis to be deleted.
+ */
+void deleteRnsBasis(rnsBasis *basis) {
+    free(basis->prime);
+    free(basis->barrett);
+    deleteCrtContext(basis->crt);
+    free(basis);
+}
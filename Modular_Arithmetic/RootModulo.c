@@ -0,0 +1,910 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * The ratio between s^2 and the bit length of p above which Cipolla-Lehmer beats Tonelli-Shanks, measured on random residues.
+ */
+#define CIPOLLA_THRESHOLD 24
+
+
+/**
+ * Computes the bit length of a positive number.
+ *
+ * @param n the number.
+ * @return the number of bits of n.
+ */
+static long long int bitLength(long long int n) {
+    return 64 - __builtin_clzll((unsigned long long int) n);
+}
+
+/**
+ * Computes a square root modulo p of a number.
+ * @details Cipolla-Lehmer algorithm: with w^2 = t^2 - a a non-residue, res = (t + w)^((p+1)/2) in F_p(w).
+ * @details it takes O(log p) products whatever the 2-adic valuation of p - 1.
+ *
+ * @param a the number reduced modulo p.
+ * @param p the odd prime module value.
+ * @return a square root modulo p of the number, -1 if a is not a quadratic residue modulo p.
+ */
+static long long int CipollaRoot(long long int a, long long int p) {
+    if (a == 0) {
+        return 0;
+    }
+    if (power(a, (p - 1) / 2, p) != 1) {
+        return -1;
+    }
+
+    //The t number st t^2 - a is a non-residue.
+    long long int t = 0;
+    //The w^2 value - t^2 - a (mod p).
+    long long int w2 = 0;
+    //The rational part of the result.
+    long long int x = 1;
+    //The w part of the result.
+    long long int y = 0;
+    //The rational part of the base - t + w.
+    long long int baseX = 0;
+    //The w part of the base - t + w.
+    long long int baseY = 1;
+    //The exponent.
+    long long int exp = (p - 1) / 2 + 1;
+
+    //half of the t values work
+    do {
+        t++;
+        w2 = sub(product(t, t, p), a, p);
+    } while (power(w2, (p - 1) / 2, p) != p - 1);
+    baseX = t;
+
+    //square and multiply in F_p(w), (x1 + y1w)(x2 + y2w) = x1x2 + y1y2w^2 + (x1y2 + x2y1)w
+    while (exp > 0) {
+        if (exp & 1) {
+            //The new rational part.
+            long long int newX = sum(product(x, baseX, p), product(product(y, baseY, p), w2, p), p);
+
+            y = sum(product(x, baseY, p), product(y, baseX, p), p);
+            x = newX;
+        }
+
+        //The new rational part of the base.
+        long long int newBaseX = sum(product(baseX, baseX, p), product(product(baseY, baseY, p), w2, p), p);
+
+        baseY = product(2, product(baseX, baseY, p), p);
+        baseX = newBaseX;
+        exp >>= 1;
+    }
+
+    //the w part is 0 since x^2 == a has a root in F_p
+    return x;
+}
+
+
+
+/**
+ * Struct --> represents the roots modulo a prime power p^e of x^k == a.
+ * @details every root is scale * root * unity[0]^i * unity[1]^j + t * step (mod module),
+ * @details with 0<=i<unitySize[0], 0<=j<unitySize[1] and 0<=t<multiplicity.
+ *
+ * @details module - the prime power p^e.
+ * @details unitModule - the prime power where the unit part of the roots lives.
+ * @details root - one unit root modulo unitModule, 0 if a == 0 (mod p^e).
+ * @details unity - the generators of the k-th roots of unity modulo unitModule.
+ * @details unitySize - the orders of the generators, unitySize[0] is 0 if there is no root.
+ * @details scale - the power of p dividing every root.
+ * @details step - the distance between two roots with the same unit part.
+ * @details multiplicity - the number of roots with the same unit part.
+ */
+typedef struct PrimePowerRoots {
+    long long int module;
+    long long int unitModule;
+    long long int root;
+    long long int unity[2];
+    long long int unitySize[2];
+    long long int scale;
+    long long int step;
+    long long int multiplicity;
+}primePowerRoots;
+
+
+/**
+ * Compares two numbers for qsort.
+ *
+ * @param a the first number.
+ * @param b the second number.
+ * @return -1, 0 or 1 if the first number is smaller, equal or greater.
+ */
+static int compareRoots(const void *a, const void *b) {
+    //The first number.
+    long long int x = *(const long long int *) a;
+    //The second number.
+    long long int y = *(const long long int *) b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * Reduces x^k == a (mod p^e) to an equation between units.
+ * @details a == 0: every multiple of p^ceil(e/k) is a root.
+ * @details a = p^(kw) * u with u a unit: x = p^w * y where y^k == u (mod p^(e-kw)), y taken modulo p^(e-w).
+ * @details if the p-adic valuation of a is not a multiple of k there is no root.
+ *
+ * @param a the number.
+ * @param k the exponent of the root.
+ * @param p the prime.
+ * @param e the exponent of the prime.
+ * @param roots the roots, every field but root and unity is set.
+ * @return the unit u modulo roots->unitModule, 0 if the roots are already complete.
+ */
+static long long int reduceToUnit(long long int a, long long int k, long long int p, long long int e, primePowerRoots *roots) {
+    //The p-adic valuation of a.
+    long long int v = 0;
+    //The smallest valuation of a root - ceil(e/k).
+    long long int c = e / k + (e % k != 0);
+
+    roots->module = 1;
+    for (long long int i = 0; i < e; ++i) {
+        roots->module *= p;
+    }
+    a = a < 0 ? modularReduction(mod(a, roots->module), roots->module) : mod(a, roots->module);
+    roots->root = 0;
+    roots->unity[0] = roots->unity[1] = 1;
+    roots->unitySize[0] = roots->unitySize[1] = 1;
+    roots->unitModule = 1;
+    roots->scale = 1;
+    roots->step = 1;
+    roots->multiplicity = 1;
+
+    if (a == 0) {
+        for (long long int i = 0; i < c; ++i) {
+            roots->step *= p;
+        }
+        roots->multiplicity = roots->module / roots->step;
+        return 0;
+    }
+
+    while (a % p == 0) {
+        a /= p;
+        v++;
+    }
+    if (v % k != 0) {
+        roots->unitySize[0] = 0;
+        return 0;
+    }
+
+    for (long long int i = 0; i < v / k; ++i) {
+        roots->scale *= p;
+    }
+    for (long long int i = 0; i < e - v; ++i) {
+        roots->unitModule *= p;
+    }
+    roots->step = roots->scale * roots->unitModule;
+    roots->multiplicity = roots->module / roots->step;
+
+    return a % roots->unitModule;
+}
+
+/**
+ * Computes the square roots of a unit modulo a prime power.
+ * @details p odd: root modulo p, then Newton-Hensel lifting y = y - (y^2 - u)/(2y), which doubles the precision every step.
+ * @details p = 2: 1 root modulo 2, 2 modulo 4, 4 modulo 2^f (f >= 3) lifted bit by bit from 1.
+ *
+ * @param u the unit reduced modulo p^f.
+ * @param p the prime.
+ * @param f the exponent, roots->unitModule = p^f.
+ * @param roots the roots, root and unity are set.
+ */
+static void unitSquareRoots(long long int u, long long int p, long long int f, primePowerRoots *roots) {
+    //The prime power.
+    long long int q = roots->unitModule;
+    //The square root.
+    long long int y = 0;
+
+    if (p == 2) {
+        roots->root = 1;
+        if (f == 1) {
+            return;
+        }
+        if (u % (f == 2 ? 4 : 8) != 1) {
+            roots->unitySize[0] = 0;
+            return;
+        }
+
+        //y^2 == u (mod 2^(j+1)) from y^2 == u (mod 2^j)
+        y = 1;
+        for (long long int j = 3; j < f; ++j) {
+            if (product(y, y, 1LL << (j + 1)) != u % (1LL << (j + 1))) {
+                y += 1LL << (j - 1);
+            }
+        }
+        roots->root = y;
+        roots->unity[0] = q - 1;
+        roots->unitySize[0] = 2;
+        if (f >= 3) {
+            roots->unity[1] = q / 2 + 1;
+            roots->unitySize[1] = 2;
+        }
+        return;
+    }
+
+    //The square-root precomputation modulo p.
+    squareRootContext *context = createSquareRootContext(p);
+
+    y = squareRootFromContext(context, u % p);
+    deleteSquareRootContext(context);
+    if (y == -1) {
+        roots->unitySize[0] = 0;
+        return;
+    }
+
+    for (long long int precision = 1; precision < f; precision *= 2) {
+        y = sub(y, product(sub(product(y, y, q), u, q), modularInverse(product(2, y, q), q), q), q);
+    }
+    roots->root = y;
+    roots->unity[0] = q - 1;
+    roots->unitySize[0] = 2;
+}
+
+/**
+ * Computes the k-th roots of a unit in a cyclic group.
+ * @details Adleman-Manders-Miller: the equation is split on the Sylow r-subgroups of the group, of order r^t generated by h.
+ * @details r does not divide k: the root is u_r^(1/k mod r^t).
+ * @details r^t divides k: u_r must be 1, every element is a root.
+ * @details otherwise the logarithm of u_r in base h, from Pohlig-Hellman, is divided by k.
+ * @details the roots are x0 * ζ^i where ζ generates the gcd(k, n)-th roots of unity.
+ *
+ * @param u the unit.
+ * @param k the exponent of the root.
+ * @param q the module value.
+ * @param n the order of the group.
+ * @param g a generator of the group.
+ * @param prime the distinct prime factors of n.
+ * @param primeSize the number of distinct prime factors of n.
+ * @param roots the roots, root and unity[0] are set.
+ */
+static void cyclicKthRoots(long long int u, long long int k, long long int q, long long int n, long long int g,
+                           long long int *prime, long long int primeSize, primePowerRoots *roots) {
+    //The number of roots - gcd(k, n).
+    long long int d = 1;
+
+    roots->root = 1;
+    for (long long int i = 0; i < primeSize; ++i) {
+        //The prime.
+        long long int r = prime[i];
+        //The order of the Sylow subgroup - r^t.
+        long long int rt = 1;
+        //The exponent of r in n.
+        long long int t = 0;
+        //The valuation of k in r.
+        long long int alpha = 0;
+        //k without its factors r.
+        long long int kr = k;
+        //The generator of the Sylow subgroup.
+        long long int h = 0;
+        //The projection of u on the Sylow subgroup - u^(n/r^t * (n/r^t)^(-1) mod r^t).
+        long long int ur = 0;
+        //The root in the Sylow subgroup.
+        long long int xr = 1;
+
+        while (n / rt % r == 0) {
+            rt *= r;
+            t++;
+        }
+        while (kr % r == 0) {
+            kr /= r;
+            alpha++;
+        }
+        h = power(g, n / rt, q);
+        ur = power(u, product(n / rt, modularInverse((n / rt) % rt, rt), n), q);
+
+        if (alpha >= t) {
+            if (ur != 1) {
+                roots->unitySize[0] = 0;
+                return;
+            }
+            d *= rt;
+        }
+        else if (alpha == 0) {
+            xr = power(ur, modularReduction(modularInverse(kr % rt, rt), rt), q);
+        }
+        else {
+            //r^alpha.
+            long long int ra = 1;
+            //The logarithm of ur in base h.
+            long long int U = PohligHellmanAlgorithm(h, ur, q, rt);
+
+            for (long long int j = 0; j < alpha; ++j) {
+                ra *= r;
+            }
+            if (U == -1 || U % ra != 0) {
+                roots->unitySize[0] = 0;
+                return;
+            }
+            xr = power(h, product(U / ra, modularInverse(kr % (rt / ra), rt / ra), rt / ra), q);
+            d *= ra;
+        }
+
+        roots->root = product(roots->root, xr, q);
+    }
+
+    roots->unity[0] = power(g, n / d, q);
+    roots->unitySize[0] = d;
+}
+
+/**
+ * Computes the k-th roots of a unit modulo a prime power.
+ * @details p odd: the units modulo p^f are cyclic of order p^(f-1) * (p-1), generated by a primitive root modulo p
+ * @details lifted to p^f, and the prime factors of the order come from the descriptor.
+ * @details p = 2: the units modulo 2^f are ±5^c, the equation is split on the sign and on the logarithm in base 5.
+ *
+ * @param u the unit reduced modulo p^f.
+ * @param k the exponent of the root.
+ * @param p the prime.
+ * @param f the exponent, roots->unitModule = p^f.
+ * @param descriptor the descriptor of a module value divisible by p^f.
+ * @param roots the roots, root and unity are set.
+ */
+static void unitKthRoots(long long int u, long long int k, long long int p, long long int f, modulusDescriptor *descriptor, primePowerRoots *roots) {
+    //The prime power.
+    long long int q = roots->unitModule;
+
+    if (p == 2) {
+        //The order of 5 - 2^(f-2).
+        long long int order = f >= 3 ? q / 4 : 1;
+        //The sign of u - u == sign * 5^V.
+        long long int sign = u % 4 == 1 ? 1 : q - 1;
+        //The logarithm of sign * u in base 5.
+        long long int V = order > 1 ? PohligHellmanAlgorithm(5, product(sign, u, q), q, order) : 0;
+        //The number of roots of 5^(ck) == 5^V - gcd(k, order).
+        long long int d = gcd(k % order + order, order);
+
+        roots->root = 1;
+        if (f == 1) {
+            return;
+        }
+        if (k % 2 == 1) {
+            //(±5^c)^k = ±5^(ck): the map is a bijection
+            roots->root = product(sign, power(5, product(V, modularInverse(k % order + order, order), order), q), q);
+            return;
+        }
+        if (sign != 1 || V % d != 0) {
+            roots->unitySize[0] = 0;
+            return;
+        }
+        if (order / d > 1) {
+            roots->root = power(5, product(V / d, modularInverse((k / d) % (order / d), order / d), order / d), q);
+        }
+        roots->unity[0] = q - 1;
+        roots->unitySize[0] = 2;
+        roots->unity[1] = power(5, order / d, q);
+        roots->unitySize[1] = d;
+        return;
+    }
+
+    //The order of the group - p^(f-1) * (p-1).
+    long long int n = q / p * (p - 1);
+    //The prime factors of n.
+    long long int *prime = malloc((descriptor->phiFactorSize > 0 ? descriptor->phiFactorSize : 1) * sizeof(long long int));
+    assert(prime != NULL);
+    //The number of prime factors of n.
+    long long int primeSize = 0;
+    //The primitive root modulo p^f.
+    long long int g = 1;
+    //1 if g is a primitive root modulo p.
+    int generator = 0;
+
+    for (long long int i = 0; i < descriptor->phiFactorSize; ++i) {
+        if (n % descriptor->phiFactor[i] == 0) {
+            prime[primeSize++] = descriptor->phiFactor[i];
+        }
+    }
+
+    //a primitive root modulo p, it is one modulo p^f unless g^(p-1) == 1 (mod p^2)
+    while (!generator) {
+        g++;
+        generator = 1;
+        for (long long int i = 0; i < primeSize && generator; ++i) {
+            if (prime[i] != p && power(g, (p - 1) / prime[i], p) == 1) {
+                generator = 0;
+            }
+        }
+    }
+    if (f >= 2 && power(g, p - 1, p * p) == 1) {
+        g += p;
+    }
+
+    cyclicKthRoots(u, k, q, n, g, prime, primeSize, roots);
+    free(prime);
+}
+
+/**
+ * Computes the k-th root at a position of the roots modulo a prime power.
+ *
+ * @param roots the roots modulo the prime power.
+ * @param index the position, 0<=index<number of roots.
+ * @return the k-th root.
+ */
+static long long int primePowerRootAt(primePowerRoots *roots, long long int index) {
+    //The position in the arithmetic progression.
+    long long int t = index % roots->multiplicity;
+    //The position in the unit roots.
+    long long int i = index / roots->multiplicity;
+    //The unit root.
+    long long int y = product(roots->root, power(roots->unity[0], i % roots->unitySize[0], roots->unitModule), roots->unitModule);
+
+    y = product(y, power(roots->unity[1], i / roots->unitySize[0], roots->unitModule), roots->unitModule);
+    return sum(product(roots->scale, y, roots->module), t * roots->step, roots->module);
+}
+
+/**
+ * Combines the roots modulo every prime power into the roots modulo their product.
+ * @details Chinese Reminder Theorem on every combination, res = sum(r_i * e_i) with e_i == 1 (mod q_i) and 0 modulo the others.
+ *
+ * @param numberOfModules the number of prime powers.
+ * @param roots the roots modulo every prime power.
+ * @param m the product of the prime powers.
+ * @param res the roots modulo m, sorted when all of them fit.
+ * @param size the number of roots res can hold.
+ * @return the number of roots modulo m.
+ */
+static long long int combineRoots(long long int numberOfModules, primePowerRoots *roots, long long int m, long long int *res, long long int size) {
+    //The number of roots.
+    long long int total = 1;
+    //The CRT coefficients.
+    long long int *coefficient = malloc((numberOfModules > 0 ? numberOfModules : 1) * sizeof(long long int));
+    assert(coefficient != NULL);
+    //The current combination.
+    long long int *index = calloc(numberOfModules > 0 ? numberOfModules : 1, sizeof(long long int));
+    assert(index != NULL);
+    //The number of roots modulo every prime power.
+    long long int *count = malloc((numberOfModules > 0 ? numberOfModules : 1) * sizeof(long long int));
+    assert(count != NULL);
+
+    for (long long int i = 0; i < numberOfModules; ++i) {
+        //M / q_i.
+        long long int mi = m / roots[i].module;
+
+        count[i] = roots[i].unitySize[0] * roots[i].unitySize[1] * roots[i].multiplicity;
+        total *= count[i];
+        coefficient[i] = product(mi, modularInverse(mi % roots[i].module, roots[i].module), m);
+    }
+
+    for (long long int k = 0; k < total && k < size; ++k) {
+        res[k] = 0;
+        for (long long int i = 0; i < numberOfModules; ++i) {
+            res[k] = sum(res[k], product(primePowerRootAt(&roots[i], index[i]), coefficient[i], m), m);
+        }
+
+        //next combination
+        for (long long int i = 0; i < numberOfModules; ++i) {
+            if (++index[i] < count[i]) {
+                break;
+            }
+            index[i] = 0;
+        }
+    }
+
+    if (total > 0 && total <= size) {
+        qsort(res, total, sizeof(long long int), compareRoots);
+    }
+    free(coefficient);
+    free(index);
+    free(count);
+    return total;
+}
+
+/**
+ * Computes all the k-th roots modulo m of a number.
+ * @details the roots modulo every prime power are combined with the Chinese Reminder Theorem.
+ *
+ * @param a the number.
+ * @param k the exponent of the root.
+ * @param m the module value.
+ * @param factor the distinct prime factors of m.
+ * @param factorSize the number of distinct prime factors of m.
+ * @param descriptor the descriptor of m, can be NULL if k is 2.
+ * @param res the roots.
+ * @param size the number of roots res can hold.
+ * @return the number of roots modulo m.
+ */
+static long long int compositeRoots(long long int a, long long int k, long long int m, long long int *factor, long long int factorSize,
+                                    modulusDescriptor *descriptor, long long int *res, long long int size) {
+    //The roots modulo every prime power.
+    primePowerRoots *roots = malloc((factorSize > 0 ? factorSize : 1) * sizeof(primePowerRoots));
+    assert(roots != NULL);
+    //The number of roots.
+    long long int total = 0;
+
+    for (long long int i = 0; i < factorSize; ++i) {
+        //The exponent of the prime factor.
+        long long int e = 0;
+        //The exponent of the unit module.
+        long long int f = 0;
+        //The unit part of a.
+        long long int u = 0;
+
+        for (long long int n = m; n % factor[i] == 0; n /= factor[i]) {
+            e++;
+        }
+        u = reduceToUnit(a, k, factor[i], e, &roots[i]);
+        if (u == 0) {
+            continue;
+        }
+        for (long long int n = roots[i].unitModule; n > 1; n /= factor[i]) {
+            f++;
+        }
+        if (k == 2) {
+            unitSquareRoots(u, factor[i], f, &roots[i]);
+        }
+        else {
+            unitKthRoots(u, k, factor[i], f, descriptor, &roots[i]);
+        }
+    }
+    total = combineRoots(factorSize, roots, m, res, size);
+
+    free(roots);
+    return total;
+}
+
+
+/**
+ * Creates the square-root precomputation modulo a prime.
+ * @details q and s come from the trailing zeros of p - 1, the non-residue from Euler's criterion.
+ * @details Tonelli-Shanks takes O(s^2) products against O(log p) for Cipolla-Lehmer, which is chosen when s^2 > 24 * log2(p).
+ * @warning p must be an odd prime number, it is not tested.
+ *
+ * @param p the prime module value.
+ * @return the square-root precomputation.
+ */
+squareRootContext *createSquareRootContext(long long int p) {
+    assert(p > 2 && p % 2 == 1);
+
+    //The square-root precomputation.
+    squareRootContext *context = malloc(sizeof(squareRootContext));
+    assert(context != NULL);
+
+    context->p = p;
+    context->s = __builtin_ctzll((unsigned long long int) (p - 1));
+    context->q = (p - 1) >> context->s;
+
+    //z is a non-residue iff z^((p-1)/2) == -1 (mod p), half of the numbers are
+    context->nonResidue = 2;
+    while (power(context->nonResidue, (p - 1) / 2, p) != p - 1) {
+        context->nonResidue++;
+    }
+    context->zq = power(context->nonResidue, context->q, p);
+    context->useCipolla = context->s * context->s > CIPOLLA_THRESHOLD * bitLength(p);
+
+    return context;
+}
+
+/**
+ * Computes a square root modulo p of a number using the square-root precomputation.
+ * @details Tonelli-Shanks algorithm, the order of t is found by repeated squaring.
+ * @details Cipolla-Lehmer algorithm when the 2-adic valuation of p - 1 makes Tonelli-Shanks too slow.
+ * @details the other square root is p - res.
+ *
+ * @param context the square-root precomputation.
+ * @param a the number whose square root is to be calculated.
+ * @return a square root modulo p of the number, -1 if a is not a quadratic residue modulo p.
+ */
+long long int squareRootFromContext(squareRootContext *context, long long int a) {
+    //The module value.
+    long long int p = context->p;
+
+    a = a < 0 ? modularReduction(mod(a, p), p) : mod(a, p);
+    if (a == 0) {
+        return 0;
+    }
+    if (context->useCipolla) {
+        return CipollaRoot(a, p);
+    }
+
+    //The c number st initialize as z^q and is updated as b^2.
+    long long int c = context->zq;
+    //The r number st initialize as a^((q+1)/2) and is updated as r*b.
+    long long int r = power(a, (context->q + 1) / 2, p);
+    //The t number st initialize as a^q and is updated as t*b^2.
+    long long int t = power(a, context->q, p);
+    //The m number st initialize as s and is updated as i.
+    long long int m = context->s;
+
+    while (t != 1) {
+        //t^(2^i) (mod p).
+        long long int t2i = t;
+        //The smallest i st t^(2^i) == 1 (mod p).
+        long long int i = 0;
+        //The b number - c^(2^(m-i-1)) (mod p).
+        long long int b = c;
+
+        //find i by repeated squaring
+        while (t2i != 1) {
+            t2i = product(t2i, t2i, p);
+            i++;
+            //the order of t is 2^m when a is not a quadratic residue
+            if (i == m) {
+                return -1;
+            }
+        }
+
+        //update the variable
+        for (long long int j = 0; j < m - i - 1; ++j) {
+            b = product(b, b, p);
+        }
+        r = product(r, b, p); //r = r*b (mod p)
+        c = product(b, b, p); //c = b^2 (mod p)
+        t = product(t, c, p); //t = t*b^2 (mod p)
+        m = i;
+    }
+
+    return r;
+}
+
+/**
+ * Computes the square roots modulo p of a number.
+ * @details Cipolla-Lehmer algorithm.
+ * @details two different result (+res && -res)
+ * @warning p must be an odd prime number, it is not tested.
+ *
+ * @param a the number whose square root is to be calculated.
+ * @param p the module value.
+ * @return the square roots modulo p of the number, NULL if a is not a quadratic residue modulo p.
+ */
+long long int *CipollaAlgorithm(long long int a, long long int p) {
+    assert(p > 2 && p % 2 == 1);
+
+    //The square root.
+    long long int r = CipollaRoot(a < 0 ? modularReduction(mod(a, p), p) : mod(a, p), p);
+
+    if (r == -1) {
+        return NULL;
+    }
+
+    //The 2 square roots.
+    long long int *res = malloc(2 * sizeof(long long int));
+    res[0] = r;
+    res[1] = modularReduction(-r, p);
+    return res;
+}
+
+/**
+ * Computes a square root modulo p of many numbers using the square-root precomputation.
+ * @details Tonelli-Shanks or Cipolla-Lehmer algorithm, as chosen by the precomputation.
+ *
+ * @param context the square-root precomputation.
+ * @param numberOfValues the number of numbers.
+ * @param a the numbers whose square roots are to be calculated.
+ * @param res a square root of every number, -1 where it is not a quadratic residue.
+ */
+void squareRootBatch(squareRootContext *context, long long int numberOfValues, long long int *a, long long int *res) {
+    for (long long int i = 0; i < numberOfValues; ++i) {
+        res[i] = squareRootFromContext(context, a[i]);
+    }
+}
+
+/**
+ * Deletes a square-root precomputation.
+ *
+ * @param context the square-root precomputation to be deleted.
+ */
+void deleteSquareRootContext(squareRootContext *context) {
+    free(context);
+}
+
+/**
+ * Computes all the square roots modulo m of a number.
+ * @details m is factorised, the roots modulo every prime power come from Tonelli-Shanks (or Cipolla-Lehmer) and Hensel lifting,
+ * @details with the special lifting for 2^k, and every combination is merged with the Chinese Reminder Theorem.
+ * @details the roots are sorted when all of them fit in res, call with size 0 to get their number.
+ *
+ * @param a the number whose square roots are to be calculated.
+ * @param m the module value.
+ * @param res the square roots, can be NULL if size is 0.
+ * @param size the number of roots res can hold.
+ * @return the number of square roots modulo m, 0 if a is not a quadratic residue modulo m.
+ */
+long long int allSquareRoots(long long int a, long long int m, long long int *res, long long int size) {
+    assert(m > 0);
+
+    //The number of prime factors.
+    long long int factorSize = 0;
+    //The prime factors of m.
+    long long int *factor = factorisation(m, &factorSize);
+    //The number of square roots.
+    long long int total = compositeRoots(a, 2, m, factor, factorSize, NULL, res, size);
+
+    free(factor);
+    return total;
+}
+
+/**
+ * Computes all the k-th roots modulo m of a number.
+ * @details the units modulo an odd prime power are cyclic: the equation is split on their Sylow subgroups (Adleman-Manders-Miller),
+ * @details the units modulo 2^f are ±5^c; the non-units are reduced to units by the p-adic valuation of a.
+ * @details the roots modulo every prime power are combined with the Chinese Reminder Theorem.
+ * @details the factorisations of m and φ(m) come from the descriptor, so many roots modulo the same m are cheap.
+ * @details the roots are sorted when all of them fit in res, call with size 0 to get their number.
+ *
+ * @param a the number whose k-th roots are to be calculated.
+ * @param k the exponent of the root.
+ * @param descriptor the descriptor of the module value.
+ * @param res the k-th roots, can be NULL if size is 0.
+ * @param size the number of roots res can hold.
+ * @return the number of k-th roots modulo m, 0 if a is not a k-th power modulo m.
+ */
+long long int allKthRoots(long long int a, long long int k, modulusDescriptor *descriptor, long long int *res, long long int size) {
+    assert(k > 0);
+
+    return compositeRoots(a, k, descriptor->m, descriptor->factor, descriptor->factorSize, descriptor, res, size);
+}
+
+/**
+ * Computes the k-th roots modulo m of a number.
+ * @details see allKthRoots.
+ * @warning a must be a k-th power modulo m.
+ *
+ * @param a the number whose k-th roots are to be calculated.
+ * @param k the exponent of the root.
+ * @param m the module value.
+ * @param numberOfRoots the number of k-th roots.
+ * @return the k-th roots modulo m of the number, sorted.
+ */
+long long int *kthRoot(long long int a, long long int k, long long int m, long long int *numberOfRoots) {
+    //The descriptor of m.
+    modulusDescriptor *descriptor = createModulusDescriptor(m);
+    //The k-th roots.
+    long long int *res = NULL;
+
+    *numberOfRoots = allKthRoots(a, k, descriptor, NULL, 0);
+    assert(*numberOfRoots > 0 && "a must be a k-th power modulo m");
+    res = malloc(*numberOfRoots * sizeof(long long int));
+    allKthRoots(a, k, descriptor, res, *numberOfRoots);
+
+    deleteModulusDescriptor(descriptor);
+    return res;
+}
+
+/**
+ * Creates the quadratic residue bitmap modulo n.
+ * @details the squares are marked from i = 0 to n/2 with (i+1)^2 = i^2 + 2i + 1, without any product, in O(n) time and n bits.
+ * @details 0 and the squares not coprime with n are residues too, as a == x^2 (mod n) has a solution.
+ *
+ * @param n the module value.
+ * @return the quadratic residue bitmap.
+ */
+quadraticResidueBitmap *createQuadraticResidueBitmap(long long int n) {
+    assert(n > 0);
+
+    //The bitmap.
+    quadraticResidueBitmap *bitmap = malloc(sizeof(quadraticResidueBitmap));
+    assert(bitmap != NULL);
+    //The square of i modulo n.
+    long long int square = 0;
+
+    bitmap->n = n;
+    bitmap->words = (n + 63) / 64;
+    bitmap->bits = calloc(bitmap->words, sizeof(unsigned long long int));
+    assert(bitmap->bits != NULL);
+
+    //(n-i)^2 == i^2 (mod n): half of the numbers are enough
+    for (long long int i = 0; i <= n / 2; ++i) {
+        bitmap->bits[square >> 6] |= 1ULL << (square & 63);
+        //square + 2i + 1 <= 2n
+        square += 2 * i + 1;
+        while (square >= n) {
+            square -= n;
+        }
+    }
+
+    return bitmap;
+}
+
+/**
+ * Creates the quadratic residue bitmap modulo n from its prime-power components.
+ * @details a is a residue modulo n iff it is a residue modulo every p^e (Chinese Reminder Theorem),
+ * @details so only the bitmaps of the prime powers are built by squaring, then every a is tested on its residues.
+ *
+ * @param descriptor the descriptor of the module value.
+ * @return the quadratic residue bitmap.
+ */
+quadraticResidueBitmap *createQuadraticResidueBitmapFromFactors(modulusDescriptor *descriptor) {
+    //The number of prime powers.
+    long long int size = descriptor->factorSize;
+    //The bitmap.
+    quadraticResidueBitmap *bitmap = malloc(sizeof(quadraticResidueBitmap));
+    assert(bitmap != NULL);
+    //The bitmaps of the prime powers.
+    quadraticResidueBitmap **component = malloc((size > 0 ? size : 1) * sizeof(quadraticResidueBitmap *));
+    assert(component != NULL);
+    //The residues of a modulo every prime power.
+    long long int *residue = calloc(size > 0 ? size : 1, sizeof(long long int));
+    assert(residue != NULL);
+
+    bitmap->n = descriptor->m;
+    bitmap->words = (bitmap->n + 63) / 64;
+    bitmap->bits = calloc(bitmap->words, sizeof(unsigned long long int));
+    assert(bitmap->bits != NULL);
+
+    for (long long int i = 0; i < size; ++i) {
+        //The prime power.
+        long long int q = 1;
+
+        for (long long int j = 0; j < descriptor->exponent[i]; ++j) {
+            q *= descriptor->factor[i];
+        }
+        component[i] = createQuadraticResidueBitmap(q);
+    }
+
+    for (long long int a = 0; a < bitmap->n; ++a) {
+        //1 if a is a residue modulo every prime power.
+        int isResidue = 1;
+
+        for (long long int i = 0; i < size; ++i) {
+            isResidue &= isQuadraticResidue(component[i], residue[i]);
+            //a + 1 modulo the prime power
+            if (++residue[i] == component[i]->n) {
+                residue[i] = 0;
+            }
+        }
+        if (isResidue) {
+            bitmap->bits[a >> 6] |= 1ULL << (a & 63);
+        }
+    }
+
+    for (long long int i = 0; i < size; ++i) {
+        deleteQuadraticResidueBitmap(component[i]);
+    }
+    free(component);
+    free(residue);
+    return bitmap;
+}
+
+/**
+ * Checks if a number is a quadratic residue using the bitmap.
+ * @details O(1) bit test.
+ *
+ * @param bitmap the quadratic residue bitmap.
+ * @param a the number.
+ * @return 1 if a is a quadratic residue modulo n, 0 otherwise.
+ */
+int isQuadraticResidue(quadraticResidueBitmap *bitmap, long long int a) {
+    a = a < 0 ? modularReduction(mod(a, bitmap->n), bitmap->n) : mod(a, bitmap->n);
+
+    return (int) ((bitmap->bits[a >> 6] >> (a & 63)) & 1);
+}
+
+/**
+ * Counts the quadratic residues lower than a bound using the bitmap.
+ * @details hardware popcount on every 64-bit word.
+ *
+ * @param bitmap the quadratic residue bitmap.
+ * @param upper the bound, at most n.
+ * @return the number of quadratic residues in [0, upper).
+ */
+long long int countQuadraticResidues(quadraticResidueBitmap *bitmap, long long int upper) {
+    assert(upper >= 0 && upper <= bitmap->n);
+
+    //The number of quadratic residues.
+    long long int res = 0;
+
+    for (long long int i = 0; i < upper >> 6; ++i) {
+        res += __builtin_popcountll(bitmap->bits[i]);
+    }
+    if (upper & 63) {
+        res += __builtin_popcountll(bitmap->bits[upper >> 6] & ((1ULL << (upper & 63)) - 1));
+    }
+
+    return res;
+}
+
+/**
+ * Deletes a quadratic residue bitmap.
+ *
+ * @param bitmap the bitmap to be deleted.
+ */
+void deleteQuadraticResidueBitmap(quadraticResidueBitmap *bitmap) {
+    free(bitmap->bits);
+    free(bitmap);
+}
@@ -58,6 +58,60 @@ long long int isFermatPseudoPrime(long long int a, long long int n) {
     return power(a, n - 1, n) == 1;
 }
 
+/**
+ * Checks if a number is a prime number with the Miller-Rabin test.
+ * @details n - 1 = d * 2^s with d odd, n is a strong probable prime to base a if a^d == 1 or a^(d * 2^r) == -1 for some r < s.
+ * @details the bases 2, 3, 5, ..., 37 make the test deterministic for every n < 2^64, O(log^3 n) and no memory.
+ *
+ * @param n the number whose primality is to be tested.
+ * @return 1 if the number is prime, 0 otherwise.
+ */
+long long int MillerRabinTest(long long int n) {
+    //The bases, the first 12 prime numbers.
+    const long long int bases[12] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    //The odd part of n - 1.
+    long long int d = n - 1;
+    //The exponent of 2 in n - 1.
+    long long int s = 0;
+
+    if (n < 2) {
+        return 0;
+    }
+    for (long long int i = 0; i < 12; ++i) {
+        if (n % bases[i] == 0) {
+            return n == bases[i];
+        }
+    }
+
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+
+    for (long long int i = 0; i < 12; ++i) {
+        //The power a^(d * 2^r).
+        long long int x = power(bases[i], d, n);
+        //The number of squares taken.
+        long long int r = 1;
+
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        for (; r < s; ++r) {
+            x = product(x, x, n);
+            if (x == n - 1) {
+                break;
+            }
+        }
+        //a is a witness of compositeness
+        if (r == s) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
 /**
  * Checks if a number is a prime number.
  * @details Eratosthenes sieve.
@@ -71,11 +125,11 @@ long long int isPrime(long long int n) {
     }
 
     //The list of all prime numbers.
-    long long int *primes = malloc((n + 1) * sizeof(int));
+    long long int *primes = malloc((n + 1) * sizeof(long long int));
     //The index of the last prime number found.
     long long int primeIndex = 0;
     //The list of all number until n.
-    long long int *numbers = malloc((n + 1) * sizeof(int));
+    long long int *numbers = malloc((n + 1) * sizeof(long long int));
 
     //array initialization: assume that all numbers are primes
     for (long long int i = 0; i < n + 1; ++i) {
@@ -112,50 +166,32 @@ long long int isPrime(long long int n) {
  * Checks if a number admits the square root modulo n.
  * @details a is a quadratic residue modulo n.
  * @details if: exist x st x^2 = a (mod n).
+ * @details counts the square roots modulo every prime power of n, see allSquareRoots; use a quadratic residue bitmap for many queries.
  *
  * @param a the number whose square root we want to know if it is possible to calculate.
  * @param n the module value.
  * @return 1 if the number allows for the square root, 0 otherwise.
  */
 long long int isSquareNumber(long long int a, long long int n) {
-    a = mod(a, n);
-
-    //Euler's criterion
-    if (isPrime(n)) {
-        return power(a, (int) ((n - 1) / 2), n) == 1;
-    }
-
-    for (long long int i = 0; i < (int) ((n - 1) / 2); ++i) {
-        if (product(i, i, n) == a) {
-            return 1;
-        }
-    }
-    return 0;
+    //a has a square root modulo every prime power of n
+    return allSquareRoots(a, n, NULL, 0) > 0;
 }
 
 /**
  * Checks is a number is a primitive root modulo n.
  * @details an integer whose powers modulo n are congruent with numbers coprime to n.
+ * @details see isPrimitiveRootFromDescriptor; use a descriptor to test many numbers modulo the same n.
  *
  * @param a the number to check if it is primitive root modulo n.
  * @param n the module value.
  * @return 1 if the number is a primitive root modulo n, 0 otherwise.
  */
 long long int isPrimitiveRoot(long long int a, long long int n) {
-    //The value of Euler function of n.
-    long long int phi = EulerFunction(n);
-    //The number of factor.
-    long long int factorPhiSize = 0;
-    //The list of factors of phi.
-    long long int *factorsPhi = factorisation(phi, &factorPhiSize);
-
-    for (long long int i = 0; i < factorPhiSize; ++i) {
-        if (power(a, (int) (phi / factorsPhi[i]), n) == 1) {
-            free(factorsPhi);
-            return 0;
-        }
-    }
+    //The descriptor of n.
+    modulusDescriptor *descriptor = createModulusDescriptor(n);
+    //The result.
+    long long int res = isPrimitiveRootFromDescriptor(a, descriptor);
 
-    free(factorsPhi);
-    return 1;
-}
\ No newline at end of file
+    deleteModulusDescriptor(descriptor);
+    return res;
+}
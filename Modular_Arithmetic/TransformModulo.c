@@ -0,0 +1,731 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "../ModularArithmetic.h"
+
+
+/**
+ * The primes below 2^62 keep the values of the transforms in [0, 2p) and their sums in [0, 4p), without overflow.
+ */
+#define LAZY_BOUND (1ULL << 62)
+
+/**
+ * The butterfly kernels are inlined with a constant lazy flag, so the lazy and the exact transforms share their code.
+ */
+#define TRANSFORM_KERNEL static inline __attribute__((always_inline))
+
+/**
+ * The number of NTT primes of the convolution modulo any m.
+ */
+#define CONVOLUTION_PRIMES 3
+
+/**
+ * The shortest sequence from which the convolution modulo any m uses the transforms, below it the schoolbook product is faster.
+ */
+#define SCHOOLBOOK_THRESHOLD 64
+
+
+/**
+ * The NTT primes of the convolution modulo any m, c * 2^k + 1 below LAZY_BOUND with k >= 55:
+ * 29 * 2^57 + 1, 69 * 2^55 + 1 and 27 * 2^56 + 1, their product is above 2^183.
+ */
+static const unsigned long long int CONVOLUTION_PRIME[CONVOLUTION_PRIMES] = {4179340454199820289ULL, 2485986994308513793ULL,
+                                                                             1945555039024054273ULL};
+
+
+/**
+ * Computes the Montgomery product.
+ * @details subtractive REDC: q = a * b * p^(-1) (mod 2^64) makes a * b - q * p a multiple of 2^64,
+ * @details so the result is hi(a * b) - hi(q * p), in (-p, p), without overflow for every odd p < 2^64;
+ * @details lazy, p is always added and the result is in (0, 2p), exact, p is added only if it is negative.
+ * @details with a twiddle factor w in Montgomery form, w * 2^64 (mod p), it is a * w (mod p) in normal form.
+ *
+ * @param a the first factor, any 64-bit number.
+ * @param b the second factor, lower than p.
+ * @param p the odd prime.
+ * @param inverse p^(-1) (mod 2^64).
+ * @param lazy 1 to skip the correction, p must be lower than LAZY_BOUND.
+ * @return a * b * 2^(-64) (mod p), lower than 2p if lazy, than p otherwise.
+ */
+TRANSFORM_KERNEL unsigned long long int transformProduct(unsigned long long int a, unsigned long long int b, unsigned long long int p,
+                                                         unsigned long long int inverse, int lazy) {
+    //The product.
+    unsigned __int128 t = (unsigned __int128) a * b;
+    //The high word of the product.
+    unsigned long long int hi = (unsigned long long int) (t >> 64);
+    //The high word of q * p.
+    unsigned long long int qp = (unsigned long long int) (((unsigned __int128) ((unsigned long long int) t * inverse) * p) >> 64);
+
+    if (lazy) {
+        return hi - qp + p;
+    }
+    return hi - qp + (p & (0 - (unsigned long long int) (hi < qp)));
+}
+
+/**
+ * Computes the sum of two values of a transform.
+ * @details exact, a + b may wrap around 2^64 when p is above 2^63, the wrap means it is above p;
+ * @details the corrections are masks and not branches, the branches would be mispredicted half of the times.
+ *
+ * @param a the first addend, lower than 2p if lazy, than p otherwise.
+ * @param b the second addend, lower than 2p if lazy, than p otherwise.
+ * @param p the prime.
+ * @param lazy 1 to skip the correction.
+ * @return the sum modulo p, lower than 4p if lazy, than p otherwise.
+ */
+TRANSFORM_KERNEL unsigned long long int transformSum(unsigned long long int a, unsigned long long int b, unsigned long long int p,
+                                                     int lazy) {
+    //The sum, modulo 2^64.
+    unsigned long long int s = a + b;
+
+    if (lazy) {
+        return s;
+    }
+    return s - (p & (0 - (unsigned long long int) ((s < a) | (s >= p))));
+}
+
+/**
+ * Computes the difference of two values of a transform.
+ *
+ * @param a the minuend, lower than 2p if lazy, than p otherwise.
+ * @param b the subtrahend, lower than 2p if lazy, than p otherwise.
+ * @param p the prime.
+ * @param lazy 1 to add 2p instead of the correction.
+ * @return the difference modulo p, lower than 4p if lazy, than p otherwise.
+ */
+TRANSFORM_KERNEL unsigned long long int transformSub(unsigned long long int a, unsigned long long int b, unsigned long long int p,
+                                                     int lazy) {
+    if (lazy) {
+        return a - b + 2 * p;
+    }
+    return a - b + (p & (0 - (unsigned long long int) (a < b)));
+}
+
+/**
+ * Reduces a sum or a difference of two values of a transform to the range of the values.
+ *
+ * @param a the sum or the difference, lower than 4p if lazy, than p otherwise.
+ * @param p the prime.
+ * @param lazy 1 if a is lazy.
+ * @return a value congruent to a, lower than 2p if lazy, than p otherwise.
+ */
+TRANSFORM_KERNEL unsigned long long int transformReduce(unsigned long long int a, unsigned long long int p, int lazy) {
+    if (lazy) {
+        return a - (2 * p & (0 - (unsigned long long int) (a >= 2 * p)));
+    }
+    return a;
+}
+
+/**
+ * Computes the power elevation in Montgomery form.
+ *
+ * @param a the base in Montgomery form.
+ * @param exp the exponent.
+ * @param context the precomputation, p, inverse and one are needed.
+ * @return a^exp in Montgomery form.
+ */
+static unsigned long long int transformPower(unsigned long long int a, unsigned long long int exp, nttContext *context) {
+    //The result, 1 in Montgomery form.
+    unsigned long long int res = context->one;
+
+    while (exp > 0) {
+        if (exp % 2 == 1) {
+            res = transformProduct(res, a, context->p, context->inverse, 0);
+        }
+        exp >>= 1;
+        a = transformProduct(a, a, context->p, context->inverse, 0);
+    }
+
+    return res;
+}
+
+/**
+ * Finds the smallest primitive root modulo an NTT prime.
+ * @details the test of isPrimitiveRootFromDescriptor on the factors of p - 1 only, the descriptor would factorise p:
+ * @details p - 1 = c * 2^k with c small and odd, c is factorised and the candidates g are tested in Montgomery form.
+ *
+ * @param context the precomputation, p, inverse, one and r2 are needed.
+ * @return the primitive root.
+ */
+static unsigned long long int transformPrimitiveRoot(nttContext *context) {
+    //The odd part of p - 1.
+    unsigned long long int c = context->p - 1;
+    //The number of prime factors of c.
+    long long int factorSize = 0;
+    //The prime factors of c.
+    long long int *factor = NULL;
+
+    while (c % 2 == 0) {
+        c /= 2;
+    }
+    factor = factorisation((long long int) c, &factorSize);
+
+    for (unsigned long long int g = 2;; ++g) {
+        //The candidate in Montgomery form.
+        unsigned long long int gm = transformProduct(g, context->r2, context->p, context->inverse, 0);
+        //1 if g^((p-1)/q) != 1 for every prime q dividing p - 1.
+        int generator = transformPower(gm, (context->p - 1) / 2, context) != context->one;
+
+        for (long long int i = 0; i < factorSize && generator; ++i) {
+            generator = transformPower(gm, (context->p - 1) / (unsigned long long int) factor[i], context) != context->one;
+        }
+        if (generator) {
+            free(factor);
+            return g;
+        }
+    }
+}
+
+/**
+ * Computes the stages of the number-theoretic transform.
+ * @details radix-4 decimation in frequency, two radix-2 stages in one pass: with i = w_4 and w = w_(4m)^j,
+ * @details (a0, a1, a2, a3) --> (a0 + a1 + a2 + a3, (a0 - a1 + a2 - a3) w^2, (a0 - a2 + i(a1 - a3)) w, (a0 - a2 - i(a1 - a3)) w^3);
+ * @details one radix-2 stage first if log2(n) is odd. Lazy, the values stay in [0, 2p): the sums feeding a product
+ * @details are not reduced, since the Montgomery product takes any 64-bit factor, the others are reduced once by 2p.
+ * @details p, inverse and the tables are passed by value: the stores through a may alias the fields of the precomputation.
+ *
+ * @param a the values, lower than 2p if lazy, than p otherwise.
+ * @param n the length.
+ * @param p the prime.
+ * @param inverse p^(-1) (mod 2^64).
+ * @param root the roots of the stages.
+ * @param root3 the cubes of the roots of the radix-4 stages.
+ * @param unity the fourth root of unity.
+ * @param lazy 1 for the lazy reduction, p must be lower than LAZY_BOUND.
+ */
+TRANSFORM_KERNEL void forwardStages(unsigned long long int *a, long long int n, unsigned long long int p, unsigned long long int inverse,
+                                    const unsigned long long int *root, const unsigned long long int *root3,
+                                    unsigned long long int unity, int lazy) {
+    //The quarter of the block length.
+    long long int m = n / 4;
+
+    //radix-2 stage of length n, if log2(n) is odd
+    if ((__builtin_ctzll((unsigned long long int) n) & 1) == 1) {
+        for (long long int j = 0; j < n / 2; ++j) {
+            //The first value.
+            unsigned long long int u = a[j];
+            //The second value.
+            unsigned long long int v = a[j + n / 2];
+
+            a[j] = transformReduce(transformSum(u, v, p, lazy), p, lazy);
+            a[j + n / 2] = transformProduct(transformSub(u, v, p, lazy), root[n / 2 + j], p, inverse, lazy);
+        }
+        m = n / 8;
+    }
+
+    for (; m >= 1; m /= 4) {
+        for (long long int s = 0; s < n; s += 4 * m) {
+            for (long long int j = 0; j < m; ++j) {
+                //The values of the butterfly.
+                unsigned long long int *x = a + s + j;
+                //a0 + a2.
+                unsigned long long int b0 = transformReduce(transformSum(x[0], x[2 * m], p, lazy), p, lazy);
+                //a0 - a2.
+                unsigned long long int b1 = transformReduce(transformSub(x[0], x[2 * m], p, lazy), p, lazy);
+                //a1 + a3.
+                unsigned long long int b2 = transformReduce(transformSum(x[m], x[3 * m], p, lazy), p, lazy);
+                //i * (a1 - a3).
+                unsigned long long int b3 = transformProduct(transformSub(x[m], x[3 * m], p, lazy), unity, p, inverse, lazy);
+
+                x[0] = transformReduce(transformSum(b0, b2, p, lazy), p, lazy);
+                x[m] = transformProduct(transformSub(b0, b2, p, lazy), root[m + j], p, inverse, lazy);
+                x[2 * m] = transformProduct(transformSum(b1, b3, p, lazy), root[2 * m + j], p, inverse, lazy);
+                x[3 * m] = transformProduct(transformSub(b1, b3, p, lazy), root3[m + j], p, inverse, lazy);
+            }
+        }
+    }
+}
+
+/**
+ * Computes the stages of the inverse number-theoretic transform.
+ * @details radix-4 decimation in time with the inverse roots, the stages of forwardStages in reverse order:
+ * @details with X0 = a0, X1 = a1 w^-2, X2 = a2 w^-1, X3 = a3 w^-3 and i^-1 the inverse of the fourth root of unity:
+ * @details (X0 + X1 + X2 + X3, X0 - X1 + i^-1(X2 - X3), X0 + X1 - X2 - X3, X0 - X1 - i^-1(X2 - X3)), without the division by n.
+ *
+ * @param a the values in bit-reversed order, lower than 2p if lazy, than p otherwise.
+ * @param n the length.
+ * @param p the prime.
+ * @param inverse p^(-1) (mod 2^64).
+ * @param root the inverse roots of the stages.
+ * @param root3 the cubes of the inverse roots of the radix-4 stages.
+ * @param unity the inverse of the fourth root of unity.
+ * @param lazy 1 for the lazy reduction, p must be lower than LAZY_BOUND.
+ */
+TRANSFORM_KERNEL void inverseStages(unsigned long long int *a, long long int n, unsigned long long int p, unsigned long long int inverse,
+                                    const unsigned long long int *root, const unsigned long long int *root3,
+                                    unsigned long long int unity, int lazy) {
+    //The quarter of the block length.
+    long long int m = 1;
+
+    for (; 4 * m <= n; m *= 4) {
+        for (long long int s = 0; s < n; s += 4 * m) {
+            for (long long int j = 0; j < m; ++j) {
+                //The values of the butterfly.
+                unsigned long long int *x = a + s + j;
+                //X0.
+                unsigned long long int x0 = x[0];
+                //X1 = a1 w^-2.
+                unsigned long long int x1 = transformProduct(x[m], root[m + j], p, inverse, lazy);
+                //X2 = a2 w^-1.
+                unsigned long long int x2 = transformProduct(x[2 * m], root[2 * m + j], p, inverse, lazy);
+                //X3 = a3 w^-3.
+                unsigned long long int x3 = transformProduct(x[3 * m], root3[m + j], p, inverse, lazy);
+                //X0 + X1.
+                unsigned long long int b0 = transformReduce(transformSum(x0, x1, p, lazy), p, lazy);
+                //X0 - X1.
+                unsigned long long int b1 = transformReduce(transformSub(x0, x1, p, lazy), p, lazy);
+                //X2 + X3.
+                unsigned long long int b2 = transformReduce(transformSum(x2, x3, p, lazy), p, lazy);
+                //i^-1 (X2 - X3).
+                unsigned long long int b3 = transformProduct(transformSub(x2, x3, p, lazy), unity, p, inverse, lazy);
+
+                x[0] = transformReduce(transformSum(b0, b2, p, lazy), p, lazy);
+                x[m] = transformReduce(transformSum(b1, b3, p, lazy), p, lazy);
+                x[2 * m] = transformReduce(transformSub(b0, b2, p, lazy), p, lazy);
+                x[3 * m] = transformReduce(transformSub(b1, b3, p, lazy), p, lazy);
+            }
+        }
+    }
+
+    //radix-2 stage of length n, if log2(n) is odd
+    if (2 * m == n) {
+        for (long long int j = 0; j < m; ++j) {
+            //The first value.
+            unsigned long long int u = a[j];
+            //The second value.
+            unsigned long long int v = transformProduct(a[j + m], root[m + j], p, inverse, lazy);
+
+            a[j] = transformReduce(transformSum(u, v, p, lazy), p, lazy);
+            a[j + m] = transformReduce(transformSub(u, v, p, lazy), p, lazy);
+        }
+    }
+}
+
+
+/**
+ * Creates the precomputation of the number-theoretic transform modulo a prime.
+ * @details the roots w_(2h)^j of every stage are stored at h + j, their cubes w_(4m)^(3j) at m + j, both in Montgomery form,
+ * @details computed from a primitive root g as w_n = g^((p-1)/n); the same for the inverse roots.
+ * @warning p must be an odd prime, maxLength a power of 2 dividing p - 1.
+ *
+ * @param p the prime, e.g. 998244353 = 119 * 2^23 + 1 or 2^64 - 2^32 + 1.
+ * @param maxLength the largest length of a transform.
+ * @return the precomputation.
+ */
+nttContext *createNttContext(unsigned long long int p, long long int maxLength) {
+    assert(p % 2 == 1 && maxLength > 0 && (maxLength & (maxLength - 1)) == 0);
+    assert((p - 1) % (unsigned long long int) maxLength == 0 && "the length must divide p - 1");
+
+    //The precomputation.
+    nttContext *context = malloc(sizeof(nttContext));
+    assert(context != NULL);
+    //2^64 (mod p).
+    unsigned long long int r = (0 - p) % p;
+    //The primitive maxLength-th root of unity and its inverse, in Montgomery form.
+    unsigned long long int w[2];
+
+    context->p = p;
+    context->maxLength = maxLength;
+    context->inverse = p;
+    for (long long int i = 0; i < 6; ++i) {
+        context->inverse *= 2 - p * context->inverse;
+    }
+    context->one = r;
+    context->r2 = (unsigned long long int) ((unsigned __int128) r * r % p);
+    context->g = transformPrimitiveRoot(context);
+
+    context->root[0] = malloc(maxLength * sizeof(unsigned long long int));
+    context->root[1] = malloc(maxLength * sizeof(unsigned long long int));
+    context->root3[0] = malloc(maxLength * sizeof(unsigned long long int));
+    context->root3[1] = malloc(maxLength * sizeof(unsigned long long int));
+    assert(context->root[0] != NULL && context->root[1] != NULL && context->root3[0] != NULL && context->root3[1] != NULL);
+
+    //g in Montgomery form.
+    w[0] = transformProduct(context->g, context->r2, p, context->inverse, 0);
+    w[0] = transformPower(w[0], (p - 1) / (unsigned long long int) maxLength, context);
+    w[1] = transformPower(w[0], (unsigned long long int) maxLength - 1, context);
+    for (long long int k = 0; k < 2; ++k) {
+        //The powers of the root of the largest stage, at maxLength / 2 + j.
+        unsigned long long int *root = context->root[k];
+
+        if (maxLength > 1) {
+            root[maxLength / 2] = context->one;
+        }
+        for (long long int j = 1; j < maxLength / 2; ++j) {
+            root[maxLength / 2 + j] = transformProduct(root[maxLength / 2 + j - 1], w[k], context->p, context->inverse, 0);
+        }
+        //w_(2h)^j = w_(4h)^(2j)
+        for (long long int h = maxLength / 4; h >= 1; h /= 2) {
+            for (long long int j = 0; j < h; ++j) {
+                root[h + j] = root[2 * h + 2 * j];
+            }
+        }
+        //w_(4m)^(3j) = w_(4m)^j * w_(4m)^(2j)
+        for (long long int m = 1; 4 * m <= maxLength; m *= 2) {
+            for (long long int j = 0; j < m; ++j) {
+                context->root3[k][m + j] = transformProduct(root[2 * m + j], root[m + j], context->p, context->inverse, 0);
+            }
+        }
+        //the fourth root of unity, w_4 = w_(4m)^m
+        context->unity[k] = maxLength >= 4 ? root[2 + 1] : context->one;
+    }
+
+    return context;
+}
+
+/**
+ * Computes the number-theoretic transform.
+ * @details radix-4 decimation in frequency with Montgomery twiddle products, one radix-2 stage first if log2(n) is odd,
+ * @details lazy below LAZY_BOUND, then the values are reduced below p. The twiddles are in Montgomery form, so the values stay in normal form.
+ * @details the result is in bit-reversed order, as needed by nttPointwiseProduct and nttInverse.
+ *
+ * @param context the precomputation.
+ * @param a the values, lower than p, transformed in place.
+ * @param n the length, a power of 2 not greater than maxLength.
+ */
+void nttForward(nttContext *context, unsigned long long int *a, long long int n) {
+    assert(n > 0 && (n & (n - 1)) == 0 && n <= context->maxLength);
+
+    //The prime.
+    unsigned long long int p = context->p;
+
+    if (p < LAZY_BOUND) {
+        forwardStages(a, n, p, context->inverse, context->root[0], context->root3[0], context->unity[0], 1);
+        for (long long int i = 0; i < n; ++i) {
+            a[i] -= p & (0 - (unsigned long long int) (a[i] >= p));
+        }
+    } else {
+        forwardStages(a, n, p, context->inverse, context->root[0], context->root3[0], context->unity[0], 0);
+    }
+}
+
+/**
+ * Computes the inverse number-theoretic transform.
+ * @details radix-4 decimation in time with the inverse roots, the stages of nttForward in reverse order,
+ * @details lazy below LAZY_BOUND, then every value is divided by n with an exact Montgomery product.
+ *
+ * @param context the precomputation.
+ * @param a the values in bit-reversed order, lower than p, transformed in place.
+ * @param n the length, a power of 2 not greater than maxLength.
+ */
+void nttInverse(nttContext *context, unsigned long long int *a, long long int n) {
+    assert(n > 0 && (n & (n - 1)) == 0 && n <= context->maxLength);
+
+    //The prime.
+    unsigned long long int p = context->p;
+    //p^(-1) (mod 2^64).
+    unsigned long long int inverse = context->inverse;
+    //n^(-1) in Montgomery form, p - (p-1)/n is the inverse of n.
+    unsigned long long int inverseN = transformProduct(p - (p - 1) / (unsigned long long int) n, context->r2, p, inverse, 0);
+
+    if (p < LAZY_BOUND) {
+        inverseStages(a, n, p, inverse, context->root[1], context->root3[1], context->unity[1], 1);
+    } else {
+        inverseStages(a, n, p, inverse, context->root[1], context->root3[1], context->unity[1], 0);
+    }
+    for (long long int i = 0; i < n; ++i) {
+        a[i] = transformProduct(a[i], inverseN, p, inverse, 0);
+    }
+}
+
+/**
+ * Computes the pointwise product of two transforms.
+ * @details a * b * 2^(-64) is multiplied by 2^128 (mod p) in Montgomery form, so the product is in normal form.
+ *
+ * @param context the precomputation.
+ * @param a the first transform.
+ * @param b the second transform.
+ * @param res the pointwise product, it may be a or b.
+ * @param n the length.
+ */
+void nttPointwiseProduct(nttContext *context, unsigned long long int *a, unsigned long long int *b, unsigned long long int *res,
+                         long long int n) {
+    //The prime.
+    unsigned long long int p = context->p;
+    //p^(-1) (mod 2^64).
+    unsigned long long int inverse = context->inverse;
+    //2^128 (mod p).
+    unsigned long long int r2 = context->r2;
+
+    for (long long int i = 0; i < n; ++i) {
+        res[i] = transformProduct(transformProduct(a[i], b[i], p, inverse, 0), r2, p, inverse, 0);
+    }
+}
+
+/**
+ * Computes the convolution of two sequences modulo the prime.
+ * @details res_k = sum(a_i * b_(k-i)): the sequences are padded to the next power of 2 n >= sizeA + sizeB - 1,
+ * @details transformed, multiplied pointwise and transformed back, O(n log n).
+ * @warning sizeA + sizeB - 1 must not be greater than maxLength.
+ *
+ * @param context the precomputation.
+ * @param a the first sequence, lower than p.
+ * @param sizeA the length of the first sequence.
+ * @param b the second sequence, lower than p.
+ * @param sizeB the length of the second sequence.
+ * @param res the convolution, sizeA + sizeB - 1 values; it may be a or b if it is large enough.
+ */
+void nttConvolution(nttContext *context, unsigned long long int *a, long long int sizeA, unsigned long long int *b,
+                    long long int sizeB, unsigned long long int *res) {
+    assert(sizeA > 0 && sizeB > 0);
+
+    //The length of the transforms.
+    long long int n = 1;
+    while (n < sizeA + sizeB - 1) {
+        n *= 2;
+    }
+    assert(n <= context->maxLength && "the convolution is longer than the precomputation");
+
+    //The padded first sequence.
+    unsigned long long int *fa = calloc(n, sizeof(unsigned long long int));
+    //The padded second sequence.
+    unsigned long long int *fb = calloc(n, sizeof(unsigned long long int));
+    assert(fa != NULL && fb != NULL);
+
+    for (long long int i = 0; i < sizeA; ++i) {
+        fa[i] = a[i];
+    }
+    for (long long int i = 0; i < sizeB; ++i) {
+        fb[i] = b[i];
+    }
+
+    nttForward(context, fa, n);
+    nttForward(context, fb, n);
+    nttPointwiseProduct(context, fa, fb, fa, n);
+    nttInverse(context, fa, n);
+    for (long long int i = 0; i < sizeA + sizeB - 1; ++i) {
+        res[i] = fa[i];
+    }
+
+    free(fa);
+    free(fb);
+}
+
+/**
+ * Deletes the precomputation of the number-theoretic transform.
+ *
+ * @param context the precomputation to be deleted.
+ */
+void deleteNttContext(nttContext *context) {
+    free(context->root[0]);
+    free(context->root[1]);
+    free(context->root3[0]);
+    free(context->root3[1]);
+    free(context);
+}
+
+
+/**
+ * Creates the precomputation of the convolution modulo any m.
+ * @details the transform precomputations of the three NTT primes and their Garner precomputation,
+ * @details so many convolutions of length up to maxLength do not rebuild the roots.
+ *
+ * @param maxLength the largest length of a transform, a power of 2 not greater than 2^55.
+ * @return the precomputation.
+ */
+convolutionContext *createConvolutionContext(long long int maxLength) {
+    //The precomputation.
+    convolutionContext *context = malloc(sizeof(convolutionContext));
+    assert(context != NULL);
+    //The NTT primes as module values of the Garner precomputation.
+    long long int prime[CONVOLUTION_PRIMES];
+
+    context->maxLength = maxLength;
+    for (long long int t = 0; t < CONVOLUTION_PRIMES; ++t) {
+        context->transform[t] = createNttContext(CONVOLUTION_PRIME[t], maxLength);
+        prime[t] = (long long int) CONVOLUTION_PRIME[t];
+    }
+    context->crt = createCrtContext(CONVOLUTION_PRIMES, prime);
+
+    return context;
+}
+
+/**
+ * Reduces a sequence modulo m.
+ *
+ * @param a the sequence.
+ * @param size the length of the sequence.
+ * @param m the module value.
+ * @return a copy of the sequence with values in [0, m).
+ */
+static unsigned long long int *reduceSequence(long long int *a, long long int size, long long int m) {
+    //The sequence, reduced modulo m.
+    unsigned long long int *res = malloc(size * sizeof(unsigned long long int));
+    assert(res != NULL);
+
+    for (long long int i = 0; i < size; ++i) {
+        res[i] = (unsigned long long int) (a[i] < 0 ? modularReduction(mod(a[i], m), m) : mod(a[i], m));
+    }
+
+    return res;
+}
+
+/**
+ * Computes the convolution of two reduced sequences modulo m with the schoolbook product, O(sizeA * sizeB).
+ *
+ * @param a the first sequence, reduced modulo m.
+ * @param sizeA the length of the first sequence.
+ * @param b the second sequence, reduced modulo m.
+ * @param sizeB the length of the second sequence.
+ * @param m the module value.
+ * @param res the convolution modulo m, sizeA + sizeB - 1 values.
+ */
+static void schoolbookConvolution(unsigned long long int *a, long long int sizeA, unsigned long long int *b, long long int sizeB,
+                                  long long int m, long long int *res) {
+    for (long long int k = 0; k < sizeA + sizeB - 1; ++k) {
+        //The coefficient.
+        unsigned long long int c = 0;
+
+        for (long long int i = k < sizeB ? 0 : k - sizeB + 1; i < sizeA && i <= k; ++i) {
+            c = (unsigned long long int) (((unsigned __int128) a[i] * b[k - i] + c) % (unsigned long long int) m);
+        }
+        res[k] = (long long int) c;
+    }
+}
+
+/**
+ * Computes the convolution of two sequences modulo any m using the precomputation of the three NTT primes.
+ * @details the exact coefficients are lower than min(sizeA, sizeB) * (m-1)^2 < 2^181, below the product of the three NTT primes:
+ * @details the convolution is computed modulo every prime with the transforms, then the mixed-radix digits v_i of every
+ * @details coefficient come from Garner's algorithm and x = v_0 + p_0 * (v_1 + p_1 * v_2) is evaluated modulo m, O(n log n).
+ * @details below SCHOOLBOOK_THRESHOLD values the schoolbook product is used, O(sizeA * sizeB).
+ * @warning sizeA + sizeB - 1 must not be greater than maxLength, unless the schoolbook product is used.
+ *
+ * @param context the precomputation of the three primes.
+ * @param a the first sequence.
+ * @param sizeA the length of the first sequence.
+ * @param b the second sequence.
+ * @param sizeB the length of the second sequence.
+ * @param m the module value.
+ * @param res the convolution modulo m, sizeA + sizeB - 1 values; it may be a or b if it is large enough.
+ */
+void convolutionFromContext(convolutionContext *context, long long int *a, long long int sizeA, long long int *b, long long int sizeB,
+                            long long int m, long long int *res) {
+    assert(sizeA > 0 && sizeB > 0 && m > 0);
+
+    //The first sequence, reduced modulo m.
+    unsigned long long int *ra = reduceSequence(a, sizeA, m);
+    //The second sequence, reduced modulo m.
+    unsigned long long int *rb = reduceSequence(b, sizeB, m);
+    //The length of the transforms.
+    long long int n = 1;
+
+    if (sizeA < SCHOOLBOOK_THRESHOLD || sizeB < SCHOOLBOOK_THRESHOLD) {
+        schoolbookConvolution(ra, sizeA, rb, sizeB, m, res);
+        free(ra);
+        free(rb);
+        return;
+    }
+
+    while (n < sizeA + sizeB - 1) {
+        n *= 2;
+    }
+    assert(n <= context->maxLength && "the convolution is longer than the precomputation");
+
+    //The convolution modulo every prime.
+    unsigned long long int *transform[CONVOLUTION_PRIMES];
+    //The transform of the second sequence.
+    unsigned long long int *second = malloc(n * sizeof(unsigned long long int));
+    assert(second != NULL);
+    //The residues of a coefficient.
+    long long int residue[CONVOLUTION_PRIMES];
+    //The mixed-radix digits of a coefficient.
+    long long int digits[CONVOLUTION_PRIMES];
+    //The primes modulo m.
+    unsigned long long int radix[CONVOLUTION_PRIMES];
+
+    for (long long int t = 0; t < CONVOLUTION_PRIMES; ++t) {
+        //The prime.
+        unsigned long long int p = CONVOLUTION_PRIME[t];
+
+        transform[t] = malloc(n * sizeof(unsigned long long int));
+        assert(transform[t] != NULL);
+        for (long long int i = 0; i < n; ++i) {
+            transform[t][i] = i < sizeA ? ra[i] % p : 0;
+            second[i] = i < sizeB ? rb[i] % p : 0;
+        }
+
+        nttForward(context->transform[t], transform[t], n);
+        nttForward(context->transform[t], second, n);
+        nttPointwiseProduct(context->transform[t], transform[t], second, transform[t], n);
+        nttInverse(context->transform[t], transform[t], n);
+
+        radix[t] = p % (unsigned long long int) m;
+    }
+
+    for (long long int k = 0; k < sizeA + sizeB - 1; ++k) {
+        //The coefficient modulo m.
+        unsigned long long int c = 0;
+
+        for (long long int t = 0; t < CONVOLUTION_PRIMES; ++t) {
+            residue[t] = (long long int) transform[t][k];
+        }
+        crtMixedRadix(context->crt, residue, digits);
+        //Horner's rule modulo m: c = v_(t) + c * p_(t)
+        for (long long int t = CONVOLUTION_PRIMES - 1; t >= 0; --t) {
+            c = (unsigned long long int) (((unsigned __int128) c * radix[t] + (unsigned long long int) digits[t]) % (unsigned long long int) m);
+        }
+        res[k] = (long long int) c;
+    }
+
+    for (long long int t = 0; t < CONVOLUTION_PRIMES; ++t) {
+        free(transform[t]);
+    }
+    free(second);
+    free(ra);
+    free(rb);
+}
+
+/**
+ * Computes the convolution of two sequences modulo any m.
+ * @details see convolutionFromContext, the precomputation is built for this convolution only;
+ * @details use a convolutionContext for many convolutions. The schoolbook product needs no precomputation.
+ *
+ * @param a the first sequence.
+ * @param sizeA the length of the first sequence.
+ * @param b the second sequence.
+ * @param sizeB the length of the second sequence.
+ * @param m the module value.
+ * @param res the convolution modulo m, sizeA + sizeB - 1 values; it may be a or b if it is large enough.
+ */
+void convolutionModulo(long long int *a, long long int sizeA, long long int *b, long long int sizeB, long long int m, long long int *res) {
+    assert(sizeA > 0 && sizeB > 0 && m > 0);
+
+    if (sizeA < SCHOOLBOOK_THRESHOLD || sizeB < SCHOOLBOOK_THRESHOLD) {
+        //The first sequence, reduced modulo m.
+        unsigned long long int *ra = reduceSequence(a, sizeA, m);
+        //The second sequence, reduced modulo m.
+        unsigned long long int *rb = reduceSequence(b, sizeB, m);
+
+        schoolbookConvolution(ra, sizeA, rb, sizeB, m, res);
+        free(ra);
+        free(rb);
+        return;
+    }
+
+    //The length of the transforms.
+    long long int n = 1;
+
+    while (n < sizeA + sizeB - 1) {
+        n *= 2;
+    }
+
+    //The precomputation of the three primes.
+    convolutionContext *context = createConvolutionContext(n);
+
+    convolutionFromContext(context, a, sizeA, b, sizeB, m, res);
+    deleteConvolutionContext(context);
+}
+
+/**
+ * Deletes the precomputation of the convolution modulo any m.
+ *
+ * @param context the precomputation to be deleted.
+ */
+void deleteConvolutionContext(convolutionContext *context) {
+    for (long long int t = 0; t < CONVOLUTION_PRIMES; ++t) {
+        deleteNttContext(context->transform[t]);
+    }
+    deleteCrtContext(context->crt);
+    free(context);
+}
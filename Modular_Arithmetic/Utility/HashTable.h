@@ -0,0 +1,99 @@
+#ifndef MODULAR_ARITHMETIC_HASH_TABLE_H
+
+    #define MODULAR_ARITHMETIC_HASH_TABLE_H
+
+    #include <stdio.h>
+
+
+    /**
+     * Struct --> represents an entry of a hash table.
+     *
+     * @details key - the key, -1 if the entry is empty.
+     * @details value - the value associated with the key.
+     */
+    typedef struct HashTableEntry {
+        long long int key;
+        long long int value;
+    }hashTableEntry;
+
+    /**
+     * Struct --> represents an open-addressing hash table with linear probing.
+     *
+     * @details entry - the entries, keys and values are stored side by side so that a probe touches a single cache line.
+     * @details capacity - the number of entries, it is a power of 2.
+     * @details size - the number of keys stored.
+     * @details bits - log2(capacity).
+     */
+    typedef struct HashTable {
+        hashTableEntry *entry;
+        long long int capacity;
+        long long int size;
+        int bits;
+    }hashTable;
+
+
+    //******************************************************************************************************************//
+
+
+    //*********************//
+    //  MANAGE HASH TABLE  //
+    //*********************//
+
+
+    /**
+     * Creates a hash table.
+     * @details the capacity is the smallest power of 2 that keeps the load factor at most 1/2.
+     *
+     * @param size the number of keys that will be stored.
+     * @return the hash table.
+     */
+    hashTable *createHashTable(long long int size);
+
+    /**
+     * Inserts a key in a hash table.
+     * @details if the key is already stored, the first value is kept.
+     * @warning key must be non-negative.
+     * @warning the hash table must not be full.
+     *
+     * @param table the hash table.
+     * @param key the key.
+     * @param value the value associated with the key.
+     * @return 1 if the key was inserted, 0 if it was already stored.
+     */
+    int insertHashTable(hashTable *table, long long int key, long long int value);
+
+    /**
+     * Searches for a key in a hash table.
+     *
+     * @param table the hash table.
+     * @param key the key to be found.
+     * @param value the value associated with the key - NOT necessary.
+     * @return 1 if the key was found, 0 otherwise.
+     */
+    int searchHashTable(hashTable *table, long long int key, long long int *value);
+
+    /**
+     * Writes a hash table to a binary file.
+     *
+     * @param table the hash table.
+     * @param file the file opened for writing.
+     */
+    void writeHashTable(hashTable *table, FILE *file);
+
+    /**
+     * Reads a hash table from a binary file.
+     * @warning the file must be positioned where writeHashTable wrote the table.
+     *
+     * @param file the file opened for reading.
+     * @return the hash table.
+     */
+    hashTable *readHashTable(FILE *file);
+
+    /**
+     * Deletes a hash table.
+     *
+     * @param table the hash table to be deleted.
+     */
+    void deleteHashTable(hashTable *table);
+
+#endif
@@ -0,0 +1,159 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "../HashTable.h"
+
+
+/**
+ * Computes the position of a key in a hash table.
+ * @details Fibonacci hashing: the key is multiplied by 2^64 / golden ratio and the top bits are kept.
+ *
+ * @param table the hash table.
+ * @param key the key.
+ * @return the position of the key.
+ */
+static long long int hashPosition(hashTable *table, long long int key) {
+    return (long long int) (((unsigned long long int) key * 0x9E3779B97F4A7C15ULL) >> (64 - table->bits));
+}
+
+
+/**
+ * Creates a hash table.
+ * @details the capacity is the smallest power of 2 that keeps the load factor at most 1/2.
+ * @details the entries are zeroed, so the empty slots written by writeHashTable are deterministic.
+ *
+ * @param size the number of keys that will be stored.
+ * @return the hash table.
+ */
+hashTable *createHashTable(long long int size) {
+    assert(size >= 0);
+
+    //The hash table to create.
+    hashTable *table = malloc(sizeof(hashTable));
+    assert(table != NULL);
+
+    table->bits = 1;
+    while ((1LL << table->bits) < 2 * size) {
+        table->bits++;
+    }
+    table->capacity = 1LL << table->bits;
+    table->size = 0;
+
+    table->entry = calloc(table->capacity, sizeof(hashTableEntry));
+    assert(table->entry != NULL);
+    for (long long int i = 0; i < table->capacity; ++i) {
+        table->entry[i].key = -1;
+    }
+
+    return table;
+}
+
+/**
+ * Inserts a key in a hash table.
+ * @details if the key is already stored, the first value is kept.
+ * @warning key must be non-negative.
+ * @warning the hash table must not be full.
+ *
+ * @param table the hash table.
+ * @param key the key.
+ * @param value the value associated with the key.
+ * @return 1 if the key was inserted, 0 if it was already stored.
+ */
+int insertHashTable(hashTable *table, long long int key, long long int value) {
+    assert(key >= 0);
+    assert(table->size < table->capacity && "the hash table is full");
+
+    //The mask used to wrap around the table.
+    long long int mask = table->capacity - 1;
+    //The position of the key.
+    long long int position = hashPosition(table, key);
+
+    while (table->entry[position].key != -1) {
+        if (table->entry[position].key == key) {
+            return 0;
+        }
+        position = (position + 1) & mask;
+    }
+
+    table->entry[position].key = key;
+    table->entry[position].value = value;
+    table->size++;
+    return 1;
+}
+
+/**
+ * Searches for a key in a hash table.
+ *
+ * @param table the hash table.
+ * @param key the key to be found.
+ * @param value the value associated with the key - NOT necessary.
+ * @return 1 if the key was found, 0 otherwise.
+ */
+int searchHashTable(hashTable *table, long long int key, long long int *value) {
+    //The mask used to wrap around the table.
+    long long int mask = table->capacity - 1;
+    //The position of the key.
+    long long int position = hashPosition(table, key);
+
+    while (table->entry[position].key != -1) {
+        if (table->entry[position].key == key) {
+            if (value != NULL) {
+                *value = table->entry[position].value;
+            }
+            return 1;
+        }
+        position = (position + 1) & mask;
+    }
+
+    return 0;
+}
+
+/**
+ * Writes a hash table to a binary file.
+ *
+ * @param table the hash table.
+ * @param file the file opened for writing.
+ */
+void writeHashTable(hashTable *table, FILE *file) {
+    fwrite(&table->bits, sizeof(int), 1, file);
+    fwrite(&table->size, sizeof(long long int), 1, file);
+    fwrite(table->entry, sizeof(hashTableEntry), table->capacity, file);
+}
+
+/**
+ * Reads a hash table from a binary file.
+ * @warning the file must be positioned where writeHashTable wrote the table.
+ *
+ * @param file the file opened for reading.
+ * @return the hash table.
+ */
+hashTable *readHashTable(FILE *file) {
+    //The hash table to read.
+    hashTable *table = malloc(sizeof(hashTable));
+    assert(table != NULL);
+    //The number of elements read.
+    size_t read = 0;
+
+    read += fread(&table->bits, sizeof(int), 1, file);
+    read += fread(&table->size, sizeof(long long int), 1, file);
+    assert(read == 2 && "the file does not contain a hash table");
+    assert(table->bits > 0 && table->bits < 63);
+
+    table->capacity = 1LL << table->bits;
+    table->entry = malloc(table->capacity * sizeof(hashTableEntry));
+    assert(table->entry != NULL);
+    read = fread(table->entry, sizeof(hashTableEntry), table->capacity, file);
+    assert(read == (size_t) table->capacity && "the file is truncated");
+
+    return table;
+}
+
+/**
+ * Deletes a hash table.
+ *
+ * @param table the hash table to be deleted.
+ */
+void deleteHashTable(hashTable *table) {
+    free(table->entry);
+    free(table);
+}
@@ -7,21 +7,132 @@
 #include "../ModularArithmetic.h"
 
 
+/**
+ * The squares modulo 64, 63, 65 and 11: bit r is 1 iff r is a square modulo the value.
+ * @details a non-square passes all four filters with probability about 1/100.
+ */
+static const unsigned long long int SQUARES_64 = 0x0202021202030213ULL;
+static const unsigned long long int SQUARES_63 = 0x0402483012450293ULL;
+static const unsigned long long int SQUARES_65[2] = {0x218A019866014613ULL, 0x1ULL};
+static const unsigned long long int SQUARES_11 = 0x23BULL;
+
+/**
+ * The bound of the trial division in factorisation, the larger factors are found with Pollard's rho.
+ */
+#define FACTORISATION_TRIAL_LIMIT 1024
+
+/**
+ * The number of differences multiplied by Pollard's rho before every gcd.
+ */
+#define RHO_BLOCK 128
+
+
+/**
+ * Checks if a residue passes the square filters modulo 63, 65 and 11.
+ *
+ * @param r the residue modulo 45045 = 63 * 65 * 11.
+ * @return 1 if the residue is a square modulo 63, 65 and 11, 0 otherwise.
+ */
+static int passesSquareFilters(unsigned long long int r) {
+    //The residue modulo 65.
+    unsigned long long int r65 = r % 65;
+
+    return ((SQUARES_63 >> (r % 63)) & 1) &&
+           ((SQUARES_65[r65 >> 6] >> (r65 & 63)) & 1) &&
+           ((SQUARES_11 >> (r % 11)) & 1);
+}
+
+/**
+ * Computes the integer square root of a number.
+ * @details floor(sqrt(n)): double-precision estimate, then exact correction on integers.
+ * @warning n must be non-negative.
+ *
+ * @param n the number.
+ * @return the largest x st x^2 <= n.
+ */
+long long int integerSquareRoot(long long int n) {
+    assert(n >= 0);
+
+    //The square root, the estimate is off by at most one: the corrections are branch-free.
+    unsigned long long int x = (unsigned long long int) sqrt((double) n);
+
+    x -= x * x > (unsigned long long int) n;
+    x += (x + 1) * (x + 1) <= (unsigned long long int) n;
+
+    return (long long int) x;
+}
+
+/**
+ * Computes the integer square root of a 128-bit number.
+ * @details floor(sqrt(n)): long double estimate, one Newton step x = (x + n/x)/2, then exact correction.
+ *
+ * @param n the number.
+ * @return the largest x st x^2 <= n.
+ */
+unsigned long long int integerSquareRoot128(unsigned __int128 n) {
+    //The largest square root of a 128-bit number.
+    const unsigned long long int maxRoot = ~0ULL;
+    //The square root estimate.
+    long double estimate = sqrtl((long double) n);
+    //The square root.
+    unsigned long long int x = estimate >= 18446744073709551615.0L ? maxRoot : (unsigned long long int) estimate;
+
+    //Newton's step, from above when long double has only 53 bits
+    if (x > 0) {
+        unsigned __int128 next = ((unsigned __int128) x + n / x) / 2;
+        x = next > maxRoot ? maxRoot : (unsigned long long int) next;
+    }
+    while ((unsigned __int128) x * x > n) {
+        x--;
+    }
+    while (x < maxRoot && (unsigned __int128) (x + 1) * (x + 1) <= n) {
+        x++;
+    }
+
+    return x;
+}
+
 /**
  * Checks if a number is a perfect square.
- * @details x = sqrt(n)
- * @details if n == x * x --> n is a perfect square
+ * @details the squares modulo 64 reject 52/64 of the numbers with one bit test, then n == x * x with x the exact integer square root.
+ * @details the filters modulo 63, 65 and 11 are left to isPerfectSquare128: here they cost more than the double-precision root.
  *
  * @param n the number.
  * @return 1 if the number is a perfect square, 0 otherwise.
  */
 long long int isPerfectSquare(long long int n) {
+    if (n < 0 || !((SQUARES_64 >> (n & 63)) & 1)) {
+        return 0;
+    }
+
     //The integer part of square root.
-    long long int sq = (long long int) sqrt(n);
+    long long int sq = integerSquareRoot(n);
 
     return sq * sq == n;
 }
 
+/**
+ * Checks if a 128-bit number is a perfect square.
+ * @details the squares modulo 64, 63, 65 and 11 reject about 99% of the numbers, then n == x * x with x the exact integer square root.
+ *
+ * @param n the number.
+ * @return 1 if the number is a perfect square, 0 otherwise.
+ */
+int isPerfectSquare128(unsigned __int128 n) {
+    if (!((SQUARES_64 >> (unsigned int) (n & 63)) & 1)) {
+        return 0;
+    }
+    //the residue modulo 45045 without a 128-bit division, 2^64 == 16 (mod 45045)
+    if (!passesSquareFilters(((unsigned long long int) (n >> 64) % 45045 * 16 + (unsigned long long int) n % 45045) % 45045)) {
+        return 0;
+    }
+
+    //The integer part of square root.
+    unsigned long long int sq = integerSquareRoot128(n);
+
+    return (unsigned __int128) sq * sq == n;
+}
+
 /**
  * Checks if a number is in a list.
  * @warning list must be not NULL.
@@ -149,6 +260,22 @@ long long int congruentNumber(long long int a, long long int m) {
     return a + rand() * m;
 }
 
+/**
+ * Computes the next pseudo-random number.
+ * @details SplitMix64 generator: deterministic for a given seed and thread-safe, every caller owns its state.
+ *
+ * @param state the state of the generator, updated.
+ * @return the pseudo-random number.
+ */
+unsigned long long int nextRandom(unsigned long long int *state) {
+    //The output.
+    unsigned long long int z = (*state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
 
 /**
  * Computes the modular reduction.
@@ -189,7 +316,7 @@ long long int modularInverse(long long int n, long long int m) {
 
 
 int compare(const void* a, const void* b) {
-    return (*(int*)a - *(int*)b);
+    return (*(long long int*)a > *(long long int*)b) - (*(long long int*)a < *(long long int*)b);
 }
 
 
@@ -213,17 +340,19 @@ long long int *realFermatFactorisation(long long int n) {
 
     //The factors.
     long long int *res = malloc(2 * sizeof(long long int));
-    //The first factor.
-    long long int x = (long long int) ceil(sqrt(n));
+    //The first factor - ceil(sqrt(n)).
+    long long int x = integerSquareRoot(n);
+    x += x * x < n;
     //The second factor.
     long long int y = x * x - n;
 
+    //(x+1)^2 - n = y + 2x + 1
     while (!isPerfectSquare(y)) {
+        y += 2 * x + 1;
         x++;
-        y = x * x - n;
     }
 
-    y = (long long int) sqrt(y);
+    y = integerSquareRoot(y);
     res[0] = x - y;
     res[1] = x + y;
 
@@ -318,39 +447,123 @@ long long int *FermatFactorisation(long long int n, long long int *factors) {
     return res;
 }
 
+/**
+ * Finds a non-trivial divisor of a composite number.
+ * @details Pollard's rho with Brent's cycle detection on x --> x^2 + c (mod n),
+ * @details the differences are multiplied in blocks of RHO_BLOCK before every gcd, O(n^(1/4)) expected steps.
+ * @warning n must be an odd composite number.
+ *
+ * @param n the number.
+ * @return a divisor of n, different from 1 and n.
+ */
+static long long int PollardRhoDivisor(long long int n) {
+    for (long long int c = 1; ; ++c) {
+        //The tortoise.
+        long long int x = 2;
+        //The hare.
+        long long int y = 2;
+        //The hare at the start of the last block.
+        long long int ys = 2;
+        //The product of the differences.
+        long long int q = 1;
+        //The divisor.
+        long long int g = 1;
+
+        for (long long int r = 1; g == 1; r *= 2) {
+            x = y;
+            for (long long int i = 0; i < r; ++i) {
+                y = sum(product(y, y, n), c, n);
+            }
+            for (long long int k = 0; k < r && g == 1; k += RHO_BLOCK) {
+                ys = y;
+                for (long long int i = 0; i < RHO_BLOCK && i < r - k; ++i) {
+                    y = sum(product(y, y, n), c, n);
+                    q = product(q, x > y ? x - y : y - x, n);
+                }
+                g = gcd(q, n);
+            }
+        }
+
+        //the block overshot: retrace it one step at a time
+        if (g == n) {
+            do {
+                ys = sum(product(ys, ys, n), c, n);
+                g = gcd(x > ys ? x - ys : ys - x, n);
+            } while (g == 1);
+        }
+        //the cycle closed modulo n itself, try another c
+        if (g != n) {
+            return g;
+        }
+    }
+}
+
 /**
  * Factorizes a number by splitting it into all of its dividends.
+ * @details trial division by the numbers below FACTORISATION_TRIAL_LIMIT, then the cofactor is split with Pollard's rho
+ * @details until every part passes the Miller-Rabin test, O(n^(1/4)) expected steps for any n below 2^63.
  *
  * @param n the number.
  * @param factors the number of factors.
- * @return the factors that make up the number.
+ * @return the factors that make up the number, sorted.
  */
 long long int *factorisation(long long int n, long long int *factors) {
-    //The factors.
-    long long int *res = NULL;
-    //Save if the number is even or odd.
-    long long int isEven = 0;
+    n = n < 0 ? -n : n;
+
+    //The factors - a number below 2^63 has at most 15 distinct prime factors.
+    long long int *res = malloc(16 * sizeof(long long int));
+    assert(res != NULL);
+    //The parts not split yet - a number below 2^63 has at most 63 prime factors.
+    long long int stack[64];
+    //The number of parts not split yet.
+    long long int stackSize = 0;
 
     (*factors) = 0;
 
-    while (n % 2 == 0) {
-        isEven = 1;
-        n /= 2;
+    if (n % 2 == 0 && n != 0) {
+        res[(*factors)++] = 2;
+        while (n % 2 == 0) {
+            n /= 2;
+        }
+    }
+
+    for (long long int d = 3; d < FACTORISATION_TRIAL_LIMIT && d <= n / d; d += 2) {
+        if (n % d == 0) {
+            res[(*factors)++] = d;
+            while (n % d == 0) {
+                n /= d;
+            }
+        }
     }
 
-    if (n != 1) {
-        res = FermatFactorisation(n, factors);
+    //what is left has no factor below FACTORISATION_TRIAL_LIMIT
+    if (n > 1) {
+        stack[stackSize++] = n;
     }
+    while (stackSize > 0) {
+        //The part to split.
+        long long int k = stack[--stackSize];
+
+        if (MillerRabinTest(k)) {
+            if (!isListed(res, *factors, k, NULL)) {
+                res[(*factors)++] = k;
+            }
+        } else {
+            //The divisor of the part.
+            long long int d = PollardRhoDivisor(k);
 
-    if (isEven) {
-        if (res == NULL) {
-            res = malloc(sizeof(long long int));
+            stack[stackSize++] = d;
+            stack[stackSize++] = k / d;
         }
-        res = realloc(res, ((*factors) + 1) * sizeof(long long int));
-        assert(res != NULL);
-        res[(*factors)++] = 2;
     }
 
+    if ((*factors) == 0) {
+        free(res);
+        return NULL;
+    }
+
+    res = realloc(res, (*factors) * sizeof(long long int));
+    assert(res != NULL);
     qsort(res, (*factors), sizeof(long long int), compare);
     return res;
 }
@@ -381,6 +594,44 @@ long long int EulerFunction(long long int n) {
     return (long long int) res;
 }
 
+/**
+ * Computes the value of the Carmichael function for a number.
+ * @details λ(n), the smallest exponent st a^λ(n) == 1 (mod n) for every a coprime to n.
+ * @details λ(2) = 1, λ(4) = 2, λ(2^e) = 2^(e-2) for e > 2, λ(p^e) = p^(e-1) * (p-1), λ(n) = lcm(λ(p^e)).
+ *
+ * @param n the number.
+ * @return the value of Carmichael's function.
+ */
+long long int CarmichaelLambda(long long int n) {
+    assert(n > 0);
+
+    //The number of factors.
+    long long int factors = 0;
+    //List of factors of n.
+    long long int *nFactors = factorisation(n, &factors);
+    //Carmichael function result.
+    long long int res = 1;
+
+    for (long long int i = 0; i < factors; ++i) {
+        //The prime factor.
+        long long int p = nFactors[i];
+        //The value of Carmichael function of the prime power.
+        long long int lambda = p - 1;
+
+        for (long long int m = n / p; m % p == 0; m /= p) {
+            lambda *= p;
+        }
+        //the units modulo 2^e with e > 2 are not cyclic
+        if (p == 2 && n % 8 == 0) {
+            lambda /= 2;
+        }
+        res = res / gcd(res, lambda) * lambda;
+    }
+
+    free(nFactors);
+    return res;
+}
+
 
 /**
  * Computes the list of prime numbers up to the n-th.
@@ -463,56 +714,114 @@ long long int nextPrimeNumber(long long int n) {
 
 /**
  * Computes the list of primitive roots modulo n.
+ * @details a primitive root g is found once, the others are g^k with gcd(k, φ(n)) = 1, one multiplication each.
+ * @details the exponents coprime to φ(n) are sieved by the prime factors of φ(n), the roots are marked in a bitmap to be listed sorted.
+ * @details there are φ(φ(n)) primitive roots if n is 1, 2, 4, p^k or 2p^k with p an odd prime, none otherwise.
  *
  * @param n the module value.
  * @param primitiveRootsSize the number of primitive root modulo n.
  * @return the list of primitive roots modulo n.
  */
 long long int *primitiveRoots(long long int n, long long int *primitiveRootsSize) {
+    //The descriptor of n.
+    modulusDescriptor *descriptor = createModulusDescriptor(n);
+    //The smallest primitive root.
+    long long int g = primitiveRootFromDescriptor(descriptor);
+    //The value of Euler function of n.
+    long long int phi = descriptor->phi;
+    //The number of primitive roots - φ(φ(n)).
+    long long int primitiveSize = g < 0 ? 0 : phi;
     //The list of primitive roots.
-    long long int *primitiveRoots = malloc(n * sizeof(long long int));
-    //The number of primitive roots.
-    long long int primitiveSize = 0;
+    long long int *primitiveRoots = NULL;
+    //The exponents k <= φ(n) sharing a factor with φ(n).
+    unsigned long long int *notCoprime = NULL;
+    //The primitive roots modulo n.
+    unsigned long long int *roots = NULL;
+    //The power g^k.
+    long long int x = 1;
+
+    if (g >= 0) {
+        for (long long int i = 0; i < descriptor->phiFactorSize; ++i) {
+            primitiveSize = primitiveSize / descriptor->phiFactor[i] * (descriptor->phiFactor[i] - 1);
+        }
+    }
+    primitiveRoots = malloc((primitiveSize > 0 ? primitiveSize : 1) * sizeof(long long int));
+    assert(primitiveRoots != NULL);
+    *primitiveRootsSize = primitiveSize;
+    if (g < 0) {
+        deleteModulusDescriptor(descriptor);
+        return primitiveRoots;
+    }
 
-    for (long long int i = 1; i < n; ++i) {
-        if (isPrimitiveRoot(i, n)) {
-            primitiveRoots[primitiveSize++] = i;
+    notCoprime = calloc(phi / 64 + 1, sizeof(unsigned long long int));
+    roots = calloc(n / 64 + 1, sizeof(unsigned long long int));
+    assert(notCoprime != NULL && roots != NULL);
+    for (long long int i = 0; i < descriptor->phiFactorSize; ++i) {
+        for (long long int k = 0; k <= phi; k += descriptor->phiFactor[i]) {
+            notCoprime[k / 64] |= 1ULL << (k % 64);
         }
     }
 
-    (*primitiveRootsSize) = primitiveSize;
-    primitiveRoots = realloc(primitiveRoots, (*primitiveRootsSize) * sizeof(long long int));
-    assert(primitiveRoots != NULL);
+    //x = g^k (mod n), the products fit in 64 bits below 2^32
+    for (long long int k = 1; k <= phi; ++k) {
+        x = n <= 0xFFFFFFFFLL ? (long long int) ((unsigned long long int) x * g % n) : product(x, g, n);
+        if (!((notCoprime[k / 64] >> (k % 64)) & 1)) {
+            roots[x / 64] |= 1ULL << (x % 64);
+        }
+    }
+
+    primitiveSize = 0;
+    for (long long int i = 0; i <= n / 64; ++i) {
+        //The primitive roots of the word still to be listed.
+        unsigned long long int word = roots[i];
+
+        while (word != 0) {
+            primitiveRoots[primitiveSize++] = 64 * i + __builtin_ctzll(word);
+            word &= word - 1;
+        }
+    }
+
+    free(notCoprime);
+    free(roots);
+    deleteModulusDescriptor(descriptor);
     return primitiveRoots;
 }
 
 /**
  * Computes the list of quadratic residuals modulo n.
+ * @details the residues are read from the quadratic residue bitmap, 0 included.
  *
  * @param n the module value.
  * @param quadraticResidualSize the number of quadratic residuals modulo n.
  * @return the list of quadratic residuals modulo n.
  */
 long long int *quadraticResiduals(long long int n, long long int *quadraticResidualSize) {
+    //The bitmap of the quadratic residuals.
+    quadraticResidueBitmap *bitmap = createQuadraticResidueBitmap(n);
     //The quadratic residuals.
-    long long int *res = malloc(n * sizeof(long long int));
+    long long int *res = malloc((countQuadraticResidues(bitmap, n) + 1) * sizeof(long long int));
     //The quadratic residuals size.
     long long int resSize = 0;
 
-    for (long long int i = 0; i < n; ++i) {
-        if (isSquareNumber(i, n)) {
-            res[resSize++] = i;
+    for (long long int i = 0; i < bitmap->words; ++i) {
+        //The residues of the word still to be listed.
+        unsigned long long int word = bitmap->bits[i];
+
+        while (word != 0) {
+            res[resSize++] = 64 * i + __builtin_ctzll(word);
+            word &= word - 1;
         }
     }
 
+    deleteQuadraticResidueBitmap(bitmap);
     *quadraticResidualSize = resSize;
-    res = realloc(res, resSize * sizeof(long long int));
     return res;
 }
 
 
 /**
  * Computes the Legendre symbol.
+ * @details Jacobi symbol of a prime, no primality test.
  * @warning p must be an odd prime number.
  *
  * @param a the number.
@@ -521,28 +830,16 @@ long long int *quadraticResiduals(long long int n, long long int *quadraticResid
  */
 long long int LegendreSymbol(long long int a, long long int p) {
     assert(p % 2 != 0);
-    assert(isPrime(p));
-
-    a = mod(a, p);
 
-    //a|p - a is a divisor of p
-    if (areCongruent(a, 0, p)) {
-        return 0;
-    }
-
-    //a is a quadratic residue modulo p
-    if (isSquareNumber(a, p)) {
-        return 1;
-    }
-
-    //a is a quadratic non-residue modulo p
-    return -1;
+    return JacobiSymbol(a, p);
 }
 
 /**
  * Computes the Jacobi symbol.
  * @details Jacobi symbol is a generalization of the Legendre symbol.
- * @warning n must be an odd number.
+ * @details binary algorithm: the factors 2 of a are removed with (2|n) = (-1)^((n^2-1)/8),
+ * @details then a and n are swapped with quadratic reciprocity, O(log^2 n) without factorisation.
+ * @warning n must be an odd positive number.
  *
  * @param a the number.
  * @param n the odd number.
@@ -550,30 +847,351 @@ long long int LegendreSymbol(long long int a, long long int p) {
  */
 long long int JacobiSymbol(long long int a, long long int n) {
     assert(n % 2 != 0 && "the number must be odd");
+    assert(n > 0);
 
-    a = mod(a, n);
-
-    //Temporary n.
-    long long int nTmp = n;
-    //The number of factors.
-    long long int factorSize = 0;
-    //The factors that make up n.
-    long long int *factors = factorisation(n, &factorSize);
+    //The numerator.
+    unsigned long long int x = (unsigned long long int) (a < 0 ? modularReduction(mod(a, n), n) : mod(a, n));
+    //The denominator.
+    unsigned long long int y = (unsigned long long int) n;
     //The Jacobi symbol.
     long long int res = 1;
 
-    for (long long int i = 0; i < factorSize; ++i) {
-        do {
-            //producer(LegendreSymbol(a, factor_i)^(factor_exponent))
-            res *= LegendreSymbol(a, factors[i]);
-            if (res == 0) {
-                free(factors);
-                return 0;
+    while (x != 0) {
+        //The number of factors 2 of x.
+        int twos = __builtin_ctzll(x);
+
+        x >>= twos;
+        //(2|y) = -1 iff y == 3, 5 (mod 8)
+        if ((twos & 1) && ((y & 7) == 3 || (y & 7) == 5)) {
+            res = -res;
+        }
+
+        //(x|y)(y|x) = -1 iff x == y == 3 (mod 4)
+        if ((x & 3) == 3 && (y & 3) == 3) {
+            res = -res;
+        }
+        //The swapped numerator.
+        unsigned long long int tmp = y % x;
+        y = x;
+        x = tmp;
+    }
+
+    //gcd(a, n) > 1
+    return y == 1 ? res : 0;
+}
+
+/**
+ * Computes the Kronecker symbol.
+ * @details Kronecker symbol is a generalization of the Jacobi symbol to every integer n.
+ * @details (a|-1) = -1 iff a < 0, (a|2) = 0 if a is even, -1 iff a == 3, 5 (mod 8), (a|0) = 1 iff a = ±1.
+ *
+ * @param a the number.
+ * @param n the number.
+ * @return the Kronecker symbol, 1, -1 or 0.
+ */
+long long int KroneckerSymbol(long long int a, long long int n) {
+    //The Kronecker symbol.
+    long long int res = 1;
+    //The number of factors 2 of n.
+    int twos = 0;
+    //The residue of a modulo 8.
+    long long int a8 = modularReduction(mod(a, 8), 8);
+
+    if (n == 0) {
+        return a == 1 || a == -1;
+    }
+    if (n < 0) {
+        n = -n;
+        if (a < 0) {
+            res = -res;
+        }
+    }
+
+    twos = __builtin_ctzll((unsigned long long int) n);
+    if (twos > 0) {
+        if (a % 2 == 0) {
+            return 0;
+        }
+        n >>= twos;
+        if ((twos & 1) && (a8 == 3 || a8 == 5)) {
+            res = -res;
+        }
+    }
+
+    return res * JacobiSymbol(a, n);
+}
+
+
+/**
+ * Creates the descriptor of a module value, so that its factorisation and the ones of φ(m) and λ(m) are computed once.
+ * @details φ(m) = prod(p^(e-1) * (p-1)), its prime factors are the ones of every p - 1 and every p with e > 1.
+ * @details λ(m) = lcm(λ(p^e)) divides φ(m), its prime factors are among the ones of φ(m).
+ *
+ * @param m the module value.
+ * @return the descriptor of the module value.
+ */
+modulusDescriptor *createModulusDescriptor(long long int m) {
+    assert(m > 0);
+
+    //The descriptor.
+    modulusDescriptor *descriptor = malloc(sizeof(modulusDescriptor));
+    assert(descriptor != NULL);
+    //The capacity of the prime factors of φ(m).
+    long long int phiCapacity = 16;
+
+    descriptor->m = m;
+    descriptor->factor = factorisation(m, &descriptor->factorSize);
+    descriptor->exponent = malloc((descriptor->factorSize > 0 ? descriptor->factorSize : 1) * sizeof(long long int));
+    assert(descriptor->exponent != NULL);
+    descriptor->phi = 1;
+    descriptor->lambda = 1;
+    descriptor->phiFactorSize = 0;
+    descriptor->phiFactor = malloc(phiCapacity * sizeof(long long int));
+    assert(descriptor->phiFactor != NULL);
+
+    for (long long int i = 0; i < descriptor->factorSize; ++i) {
+        //The prime factor.
+        long long int p = descriptor->factor[i];
+        //The number of prime factors of p - 1.
+        long long int pFactorSize = 0;
+        //The prime factors of p - 1.
+        long long int *pFactor = factorisation(p - 1, &pFactorSize);
+
+        descriptor->exponent[i] = 0;
+        for (long long int n = m; n % p == 0; n /= p) {
+            descriptor->exponent[i]++;
+        }
+        descriptor->phi *= p - 1;
+        //The value of Carmichael function of p^e.
+        long long int lambda = p - 1;
+        for (long long int j = 1; j < descriptor->exponent[i]; ++j) {
+            descriptor->phi *= p;
+            lambda *= p;
+        }
+        //the units modulo 2^e with e > 2 are not cyclic
+        if (p == 2 && descriptor->exponent[i] > 2) {
+            lambda /= 2;
+        }
+        descriptor->lambda = descriptor->lambda / gcd(descriptor->lambda, lambda) * lambda;
+
+        //merge p - 1 and p into the distinct prime factors of φ(m)
+        for (long long int j = 0; j <= pFactorSize; ++j) {
+            //The candidate prime factor.
+            long long int q = j < pFactorSize ? pFactor[j] : p;
+
+            if ((j == pFactorSize && descriptor->exponent[i] == 1) ||
+                isListed(descriptor->phiFactor, descriptor->phiFactorSize, q, NULL)) {
+                continue;
+            }
+            if (descriptor->phiFactorSize == phiCapacity) {
+                phiCapacity *= 2;
+                descriptor->phiFactor = realloc(descriptor->phiFactor, phiCapacity * sizeof(long long int));
+                assert(descriptor->phiFactor != NULL);
             }
-            nTmp /= factors[i];
-        } while (nTmp % factors[i] == 0);
+            descriptor->phiFactor[descriptor->phiFactorSize++] = q;
+        }
+        free(pFactor);
+    }
+
+    qsort(descriptor->phiFactor, descriptor->phiFactorSize, sizeof(long long int), compare);
+    descriptor->phiExponent = malloc((descriptor->phiFactorSize > 0 ? descriptor->phiFactorSize : 1) * sizeof(long long int));
+    assert(descriptor->phiExponent != NULL);
+    for (long long int i = 0; i < descriptor->phiFactorSize; ++i) {
+        descriptor->phiExponent[i] = 0;
+        for (long long int n = descriptor->phi; n % descriptor->phiFactor[i] == 0; n /= descriptor->phiFactor[i]) {
+            descriptor->phiExponent[i]++;
+        }
+    }
+
+    //the prime factors of λ(m) are among the ones of φ(m)
+    descriptor->lambdaFactor = malloc((descriptor->phiFactorSize > 0 ? descriptor->phiFactorSize : 1) * sizeof(long long int));
+    descriptor->lambdaExponent = malloc((descriptor->phiFactorSize > 0 ? descriptor->phiFactorSize : 1) * sizeof(long long int));
+    assert(descriptor->lambdaFactor != NULL && descriptor->lambdaExponent != NULL);
+    descriptor->lambdaFactorSize = 0;
+    for (long long int i = 0; i < descriptor->phiFactorSize; ++i) {
+        //The exponent of the prime factor in λ(m).
+        long long int exponent = 0;
+
+        for (long long int n = descriptor->lambda; n % descriptor->phiFactor[i] == 0; n /= descriptor->phiFactor[i]) {
+            exponent++;
+        }
+        if (exponent > 0) {
+            descriptor->lambdaFactor[descriptor->lambdaFactorSize] = descriptor->phiFactor[i];
+            descriptor->lambdaExponent[descriptor->lambdaFactorSize++] = exponent;
+        }
+    }
+
+    return descriptor;
+}
+
+/**
+ * Deletes the descriptor of a module value.
+ *
+ * @param descriptor the descriptor to be deleted.
+ */
+void deleteModulusDescriptor(modulusDescriptor *descriptor) {
+    free(descriptor->factor);
+    free(descriptor->exponent);
+    free(descriptor->phiFactor);
+    free(descriptor->phiExponent);
+    free(descriptor->lambdaFactor);
+    free(descriptor->lambdaExponent);
+    free(descriptor);
+}
+
+/**
+ * Checks if there are primitive roots modulo the module value of a descriptor.
+ * @details the units modulo m are cyclic iff m is 1, 2, 4, p^k or 2p^k with p an odd prime.
+ *
+ * @param descriptor the descriptor of the module value.
+ * @return 1 if there are primitive roots modulo m, 0 otherwise.
+ */
+long long int hasPrimitiveRoot(modulusDescriptor *descriptor) {
+    if (descriptor->m <= 4) {
+        return 1;
+    }
+
+    //p^k with p odd, or 2p^k with p odd
+    return (descriptor->factorSize == 1 && descriptor->factor[0] != 2) ||
+           (descriptor->factorSize == 2 && descriptor->factor[0] == 2 && descriptor->exponent[0] == 1);
+}
+
+/**
+ * Checks is a number is a primitive root modulo the module value of a descriptor.
+ * @details the units modulo m must be cyclic, a coprime to m and a^(φ(m)/q) != 1 for every prime q dividing φ(m).
+ * @details the prime factors of φ(m) are read from the descriptor, they are not recomputed.
+ *
+ * @param a the number to check if it is primitive root modulo m.
+ * @param descriptor the descriptor of the module value.
+ * @return 1 if the number is a primitive root modulo m, 0 otherwise.
+ */
+long long int isPrimitiveRootFromDescriptor(long long int a, modulusDescriptor *descriptor) {
+    //The module value.
+    long long int m = descriptor->m;
+
+    a = a < 0 ? modularReduction(mod(a, m), m) : mod(a, m);
+    if (!hasPrimitiveRoot(descriptor) || gcd(a, m) != 1) {
+        return 0;
+    }
+
+    for (long long int i = 0; i < descriptor->phiFactorSize; ++i) {
+        if (power(a, descriptor->phi / descriptor->phiFactor[i], m) == 1) {
+            return 0;
+        }
     }
 
-    free(factors);
+    return 1;
+}
+
+/**
+ * Finds the smallest primitive root modulo the module value of a descriptor.
+ * @details sequential search: every candidate costs one exponentiation per prime factor of φ(m), factorised once.
+ * @details the smallest primitive root is O(p^(1/4 + ε)) modulo a prime p, so only few candidates are tested.
+ *
+ * @param descriptor the descriptor of the module value.
+ * @return the smallest primitive root modulo m, -1 if there are no primitive roots modulo m.
+ */
+long long int primitiveRootFromDescriptor(modulusDescriptor *descriptor) {
+    if (!hasPrimitiveRoot(descriptor)) {
+        return -1;
+    }
+
+    for (long long int g = 0; g < descriptor->m; ++g) {
+        if (isPrimitiveRootFromDescriptor(g, descriptor)) {
+            return g;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Finds the smallest primitive root modulo n.
+ * @details see primitiveRootFromDescriptor.
+ *
+ * @param n the module value.
+ * @return the smallest primitive root modulo n, -1 if there are no primitive roots modulo n.
+ */
+long long int primitiveRoot(long long int n) {
+    //The descriptor of n.
+    modulusDescriptor *descriptor = createModulusDescriptor(n);
+    //The smallest primitive root.
+    long long int res = primitiveRootFromDescriptor(descriptor);
+
+    deleteModulusDescriptor(descriptor);
     return res;
 }
+
+/**
+ * Computes the multiplicative order modulo the module value of a descriptor.
+ * @details the order divides λ(m): for every prime q^f dividing λ(m), y = a^(λ(m)/q^f) is raised to q until it is 1,
+ * @details the number of times is the exponent of q in the order; the factorisation of λ(m) is read from the descriptor.
+ *
+ * @param a the number.
+ * @param descriptor the descriptor of the module value.
+ * @return the smallest k > 0 st a^k == 1 (mod m), 0 if a and m are not coprime.
+ */
+long long int multiplicativeOrderFromDescriptor(long long int a, modulusDescriptor *descriptor) {
+    //The module value.
+    long long int m = descriptor->m;
+    //The multiplicative order.
+    long long int order = 1;
+
+    a = a < 0 ? modularReduction(mod(a, m), m) : mod(a, m);
+    if (gcd(a, m) != 1) {
+        return 0;
+    }
+
+    for (long long int i = 0; i < descriptor->lambdaFactorSize; ++i) {
+        //The prime factor of λ(m).
+        long long int q = descriptor->lambdaFactor[i];
+        //The prime power q^f dividing λ(m).
+        long long int qf = 1;
+        //The element a^(λ(m)/q^f), its order is a power of q.
+        long long int y = 0;
+
+        for (long long int j = 0; j < descriptor->lambdaExponent[i]; ++j) {
+            qf *= q;
+        }
+        y = power(a, descriptor->lambda / qf, m);
+        while (y != 1 % m) {
+            y = power(y, q, m);
+            order *= q;
+        }
+    }
+
+    return order;
+}
+
+/**
+ * Computes the multiplicative order modulo n.
+ * @details see multiplicativeOrderFromDescriptor.
+ *
+ * @param a the number.
+ * @param n the module value.
+ * @return the smallest k > 0 st a^k == 1 (mod n), 0 if a and n are not coprime.
+ */
+long long int multiplicativeOrder(long long int a, long long int n) {
+    //The descriptor of n.
+    modulusDescriptor *descriptor = createModulusDescriptor(n);
+    //The multiplicative order.
+    long long int res = multiplicativeOrderFromDescriptor(a, descriptor);
+
+    deleteModulusDescriptor(descriptor);
+    return res;
+}
+
+/**
+ * Computes the multiplicative order of many numbers modulo the module value of a descriptor.
+ * @details see multiplicativeOrderFromDescriptor, λ(m) is factorised once for every number.
+ *
+ * @param descriptor the descriptor of the module value.
+ * @param numberOfValues the number of numbers.
+ * @param a the numbers.
+ * @param res the multiplicative order of every number, 0 where it is not coprime to m.
+ */
+void multiplicativeOrderBatch(modulusDescriptor *descriptor, long long int numberOfValues, long long int *a, long long int *res) {
+    for (long long int i = 0; i < numberOfValues; ++i) {
+        res[i] = multiplicativeOrderFromDescriptor(a[i], descriptor);
+    }
+}